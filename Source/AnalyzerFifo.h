@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    AnalyzerFifo.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+    Mono sample queue from the audio thread to the spectrum analyzer. The storage is
+    allocated up front; the audio thread mixes each block down into it and drops
+    whatever doesn't fit, so it never waits for the reader. Pushing is skipped
+    entirely while no analyzer is listening.
+*/
+class AnalyzerFifo
+{
+public:
+    static constexpr int capacity = 1 << 15;
+
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+
+    template <typename SampleType>
+    void push(const juce::AudioBuffer<SampleType>& buffer)
+    {
+        auto numChannels = buffer.getNumChannels();
+
+        if (! enabled.load(std::memory_order_relaxed) || numChannels == 0)
+            return;
+
+        const auto scope = fifo.write(buffer.getNumSamples());
+        auto scale = 1.f / static_cast<float>(numChannels);
+
+        auto mixDown = [&](int destIndex, int numSamples, int sourceIndex)
+        {
+            if (numSamples == 0)
+                return;
+
+            auto* dest = samples.data() + destIndex;
+
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                juce::FloatVectorOperations::copyWithMultiply(dest, buffer.getReadPointer(0, sourceIndex), scale, numSamples);
+
+                for (auto ch = 1; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::addWithMultiply(dest, buffer.getReadPointer(ch, sourceIndex), scale, numSamples);
+            }
+            else
+            {
+                //the analyzer only needs float, so double input is narrowed while mixing
+                std::fill(dest, dest + numSamples, 0.f);
+
+                for (auto ch = 0; ch < numChannels; ++ch)
+                {
+                    auto* source = buffer.getReadPointer(ch, sourceIndex);
+
+                    for (auto i = 0; i < numSamples; ++i)
+                        dest[i] += static_cast<float>(source[i]) * scale;
+                }
+            }
+        };
+
+        mixDown(scope.startIndex1, scope.blockSize1, 0);
+        mixDown(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+    }
+
+    /** Reader side: copies up to maxSamples into dest and returns how many it copied. */
+    int pull(float* dest, int maxSamples)
+    {
+        const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+        std::copy(samples.data() + scope.startIndex1, samples.data() + scope.startIndex1 + scope.blockSize1, dest);
+        std::copy(samples.data() + scope.startIndex2, samples.data() + scope.startIndex2 + scope.blockSize2, dest + scope.blockSize1);
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::vector<float> samples = std::vector<float>(capacity, 0.f);
+    std::atomic<bool> enabled { false };
+};
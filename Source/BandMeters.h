@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    BandMeters.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Params.h"
+
+/** Levels of one band over one processed block, linear gain except for the reduction. */
+struct BandLevels
+{
+    float inputPeak = 0.f;
+    float inputRms = 0.f;
+    float outputPeak = 0.f;
+    float outputRms = 0.f;
+    float gainReductionDb = 0.f;    // <= 0
+};
+
+struct MeterFrame
+{
+    juce::int64 endSample = 0;      // samples processed when the frame was taken
+    std::array<BandLevels, Params::NumBands> bands {};
+};
+
+/*
+    Single producer, single consumer queue of meter frames. The audio thread pushes one
+    frame per block and drops it if the reader has fallen behind; nothing locks or
+    allocates. Only one reader may pop at a time, either a MeterReader or a tool that
+    drains it directly after each processBlock.
+*/
+class MeterFifo
+{
+public:
+    static constexpr int capacity = 256;
+
+    bool push(const MeterFrame& frame)
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 == 0)
+            return false;
+
+        frames[static_cast<size_t>(scope.startIndex1)] = frame;
+        return true;
+    }
+
+    bool pop(MeterFrame& frame)
+    {
+        const auto scope = fifo.read(1);
+
+        if (scope.blockSize1 == 0)
+            return false;
+
+        frame = frames[static_cast<size_t>(scope.startIndex1)];
+        return true;
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<MeterFrame, capacity> frames;
+};
+
+/*
+    Message thread consumer: drains the FIFO on a timer and folds everything that
+    arrived since the last tick into one frame, keeping the highest peaks and the
+    deepest gain reduction so short events aren't lost between repaints.
+*/
+class MeterReader  : private juce::Timer
+{
+public:
+    MeterReader(MeterFifo& f, int refreshRateHz = 30) : fifo(f)
+    {
+        //whatever queued up while nobody was reading is stale
+        MeterFrame stale;
+        while (fifo.pop(stale)) {}
+
+        startTimerHz(refreshRateHz);
+    }
+
+    ~MeterReader() override
+    {
+        stopTimer();
+    }
+
+    const MeterFrame& getLevels() const { return levels; }
+
+    /** Called after each tick that received new frames. */
+    std::function<void()> onUpdate;
+
+private:
+    MeterFifo& fifo;
+    MeterFrame levels;
+
+    void timerCallback() override
+    {
+        MeterFrame frame;
+        auto isFirst = true;
+
+        while (fifo.pop(frame))
+        {
+            if (isFirst)
+            {
+                levels = frame;
+                isFirst = false;
+                continue;
+            }
+
+            levels.endSample = frame.endSample;
+
+            for (size_t b = 0; b < levels.bands.size(); ++b)
+            {
+                auto& l = levels.bands[b];
+                const auto& f = frame.bands[b];
+
+                l.inputPeak = juce::jmax(l.inputPeak, f.inputPeak);
+                l.outputPeak = juce::jmax(l.outputPeak, f.outputPeak);
+                l.gainReductionDb = juce::jmin(l.gainReductionDb, f.gainReductionDb);
+                l.inputRms = f.inputRms;
+                l.outputRms = f.outputRms;
+            }
+        }
+
+        if (! isFirst && onUpdate != nullptr)
+            onUpdate();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(MeterReader)
+};
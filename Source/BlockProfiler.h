@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    BlockProfiler.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StageTimings.h"
+#include "RealtimeGuard.h"
+
+/*
+    Load statistics over many blocks, for SIMPLEMBCOMP_STAGE_TIMING builds.
+
+    The audio thread adds every block's StageTimings to running totals and its load,
+    the time the block took over the time it lasts, to a histogram. The audio thread is
+    the only writer and every counter is a relaxed atomic, so nothing locks; a reader
+    takes the counts with exchange, which also restarts them.
+
+    When exporting, a background thread appends one CSV row to a file every interval:
+    the number of blocks, their mean and worst load, the histogram, the mean time per
+    block of each stage and the RealtimeGuard violations so far.
+*/
+class BlockProfiler  : private juce::Thread
+{
+public:
+    static constexpr int numBuckets = 21;           // 5% of the budget each, the last one for overruns
+    static constexpr double bucketWidth = 0.05;
+
+    struct Snapshot
+    {
+        juce::int64 numBlocks = 0;
+        juce::int64 totalTicks = 0, totalBudgetTicks = 0;
+        float maxLoad = 0.f;
+        std::array<juce::int64, numBuckets> histogram {};
+        std::array<juce::int64, StageTimings::numStages> stageTicks {};
+    };
+
+    BlockProfiler() : juce::Thread("Block profiler") {}
+
+    ~BlockProfiler() override
+    {
+        stopThread(1000);
+    }
+
+    /** Appends a row to the file every intervalMs; not for the audio thread. */
+    void startExporting(const juce::File& file, int intervalMs)
+    {
+        stopThread(1000);
+
+        exportFile = file;
+        exportIntervalMs = intervalMs;
+
+        if (! exportFile.existsAsFile())
+            exportFile.replaceWithText(getHeader());
+
+        startThread();
+    }
+
+    /** Audio thread: one processed block of numSamples at sampleRate. */
+    void addBlock(const StageTimings& timings, juce::int64 blockTicks, int numSamples, double sampleRate)
+    {
+        auto budgetTicks = static_cast<juce::int64>(ticksPerSecond * numSamples / sampleRate);
+        if (budgetTicks <= 0)
+            return;
+
+        auto load = static_cast<float>(static_cast<double>(blockTicks) / static_cast<double>(budgetTicks));
+        auto bucket = juce::jlimit(0, numBuckets - 1, static_cast<int>(load / bucketWidth));
+
+        numBlocks.fetch_add(1, std::memory_order_relaxed);
+        totalTicks.fetch_add(blockTicks, std::memory_order_relaxed);
+        totalBudgetTicks.fetch_add(budgetTicks, std::memory_order_relaxed);
+        histogram[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+
+        if (load > maxLoad.load(std::memory_order_relaxed))
+            maxLoad.store(load, std::memory_order_relaxed);
+
+        for (size_t s = 0; s < stageTicks.size(); ++s)
+            stageTicks[s].fetch_add(timings.ticks[s], std::memory_order_relaxed);
+    }
+
+    /** Everything added since the last snapshot. */
+    Snapshot takeSnapshot()
+    {
+        Snapshot snapshot;
+        snapshot.numBlocks = numBlocks.exchange(0, std::memory_order_relaxed);
+        snapshot.totalTicks = totalTicks.exchange(0, std::memory_order_relaxed);
+        snapshot.totalBudgetTicks = totalBudgetTicks.exchange(0, std::memory_order_relaxed);
+        snapshot.maxLoad = maxLoad.exchange(0.f, std::memory_order_relaxed);
+
+        for (size_t b = 0; b < histogram.size(); ++b)
+            snapshot.histogram[b] = histogram[b].exchange(0, std::memory_order_relaxed);
+
+        for (size_t s = 0; s < stageTicks.size(); ++s)
+            snapshot.stageTicks[s] = stageTicks[s].exchange(0, std::memory_order_relaxed);
+
+        return snapshot;
+    }
+
+    /** Times a whole block and hands it to the profiler when it goes out of scope. */
+    class ScopedBlock
+    {
+    public:
+       #if SIMPLEMBCOMP_STAGE_TIMING
+        ScopedBlock(BlockProfiler& p, const StageTimings& t, int n, double rate)
+            : profiler(p), timings(t), numSamples(n), sampleRate(rate), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedBlock() { profiler.addBlock(timings, juce::Time::getHighResolutionTicks() - start, numSamples, sampleRate); }
+
+       private:
+        BlockProfiler& profiler;
+        const StageTimings& timings;
+        int numSamples;
+        double sampleRate;
+        juce::int64 start;
+       #else
+        ScopedBlock(BlockProfiler&, const StageTimings&, int, double) {}
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    std::atomic<juce::int64> numBlocks { 0 }, totalTicks { 0 }, totalBudgetTicks { 0 };
+    std::atomic<float> maxLoad { 0.f };
+    std::array<std::atomic<juce::int64>, numBuckets> histogram {};
+    std::array<std::atomic<juce::int64>, StageTimings::numStages> stageTicks {};
+
+    const double ticksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    juce::File exportFile;
+    int exportIntervalMs = 5000;
+
+    static juce::String getHeader()
+    {
+        juce::String header("time,blocks,mean_load,max_load,realtime_violations");
+
+        for (auto b = 0; b < numBuckets; ++b)
+            header << ",load_" << juce::roundToInt(100 * b * bucketWidth) << (b == numBuckets - 1 ? "_plus" : "");
+
+        for (auto stage = 0; stage < StageTimings::numStages; ++stage)
+            header << ",stage_" << StageTimings::getStageName(stage) << "_us_per_block";
+
+        return header + "\n";
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait(exportIntervalMs);
+
+            auto snapshot = takeSnapshot();
+            if (snapshot.numBlocks == 0)
+                continue;
+
+            auto microsecondsPerTick = 1.0e6 / ticksPerSecond;
+            auto blocks = static_cast<double>(snapshot.numBlocks);
+
+            juce::String row;
+            row << juce::Time::getCurrentTime().toISO8601(true) << ',' << snapshot.numBlocks << ','
+                << static_cast<double>(snapshot.totalTicks) / static_cast<double>(snapshot.totalBudgetTicks) << ','
+                << snapshot.maxLoad << ',' << RealtimeGuard::getViolationCount();
+
+            for (auto count : snapshot.histogram)
+                row << ',' << count;
+
+            for (auto ticks : snapshot.stageTicks)
+                row << ',' << static_cast<double>(ticks) * microsecondsPerTick / blocks;
+
+            exportFile.appendText(row + "\n");
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(BlockProfiler)
+};
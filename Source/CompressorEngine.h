@@ -0,0 +1,634 @@
+/*
+  ==============================================================================
+
+    CompressorEngine.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BandMeters.h"
+#include "FastMath.h"
+
+/** What the detector envelopes follow; the values are the Channel Link choice indices. */
+enum class DetectionMode
+{
+    unlinked,       // one envelope per channel
+    linked,         // one envelope fed with the loudest channel
+    midSide         // a stereo pair compressed as mid and side, one envelope each
+};
+
+/** The values are the Detector choice indices. */
+enum class LevelDetector
+{
+    peak,
+    rms
+};
+
+/*
+    Feed-forward compressor for the channels of one band, with a lookahead delay.
+
+    A block goes through in stages, each a loop over the samples of one row of a scratch
+    buffer, so everything but the envelope recursion vectorises across samples: the
+    detector levels, then the envelopes, then the gain computer on SIMD registers of
+    consecutive samples, and last the delay, the gains and the metering. The
+    ballistics are the ones of juce::dsp::BallisticsFilter. The gain computer works in
+    dB with a quadratic soft knee written as clamps, so every lane takes the same path
+    and a zero knee is the hard knee:
+
+        over = level - threshold
+        t    = clamp(over + knee / 2, 0, knee)
+        gain = (1 / ratio - 1) * (t^2 / (2 knee) + max(over - knee / 2, 0))
+
+    Peak detection follows |x|. RMS detection smooths x^2 and reads it as power, so it
+    never needs a square root. Samples below the knee skip the logarithms entirely.
+
+    A new threshold is glided to in steps of updateInterval samples, so automating it
+    doesn't step the gain; each step only redoes the few gain computer constants, and
+    lands on the first register after the step is due.
+*/
+template <typename SampleType>
+class CompressorEngine
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int updateInterval = 32;
+    static constexpr double glideSeconds = 0.05;
+    static constexpr double lookaheadFadeSeconds = 0.01;
+
+    /** Allocates the delay line, the envelopes and the scratch rows; not for the audio thread. */
+    void prepare(const juce::dsp::ProcessSpec& spec, int maxLookaheadSamples)
+    {
+        sampleRate = spec.sampleRate;
+        numChannels = static_cast<int>(spec.numChannels);
+
+        //mid/side needs two envelopes even where the band has fewer channels
+        auto maxEnvelopes = static_cast<size_t>(juce::jmax(2, numChannels));
+        envelopes.assign(maxEnvelopes, SampleType(0));
+
+        //whole registers per row, so the gain computer never needs a scalar tail
+        rowLength = static_cast<int>((juce::jmax(static_cast<size_t>(spec.maximumBlockSize), vecSize) + vecSize - 1) / vecSize * vecSize);
+        rowStorage.allocate(maxEnvelopes * static_cast<size_t>(rowLength) * sizeof(SampleType) + Vec::SIMDRegisterSize, true);
+        rows = juce::snapPointerToAlignment(reinterpret_cast<SampleType*>(rowStorage.getData()), Vec::SIMDRegisterSize);
+
+        //a whole row more than the longest lookahead, so a block can go in before any of it comes out
+        maxLookahead = maxLookaheadSamples;
+        delayLine.setSize(numChannels, maxLookahead + rowLength);
+        lookaheadSamples = juce::jmin(lookaheadSamples, maxLookahead);
+        fadeBuffer.setSize(numChannels, rowLength);
+        lookaheadFadeLength = juce::jmax(1, juce::roundToInt(lookaheadFadeSeconds * sampleRate));
+
+        //a freshly prepared engine starts at its settings rather than gliding to them
+        glideUpdates = juce::jmax(1, juce::roundToInt(glideSeconds * sampleRate / updateInterval));
+        thresholdDb = targetThresholdDb;
+        remainingUpdates = 0;
+
+        updateBallistics();
+        updateGainComputer();
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(envelopes.begin(), envelopes.end(), SampleType(0));
+        delayLine.clear();
+        writeIndex = 0;
+        lookaheadFadeRemaining = 0;
+        hasPlayed = false;
+    }
+
+    /** Never reallocates; the delay line already holds the longest lookahead. Once
+        something has played, the output crossfades from the old delay to the new one over
+        lookaheadFadeSeconds rather than jumping, which would click. */
+    void setLookahead(int numSamples)
+    {
+        jassert(numSamples >= 0 && numSamples <= maxLookahead);
+
+        //a change in the middle of a fade starts a new one from the delay that was fading in
+        if (numSamples != lookaheadSamples && hasPlayed)
+        {
+            fadeFromLookahead = lookaheadSamples;
+            lookaheadFadeRemaining = lookaheadFadeLength;
+        }
+
+        lookaheadSamples = numSamples;
+    }
+
+    /** The envelopes mean something else afterwards, so they restart from zero. */
+    void setDetectionMode(DetectionMode newMode)
+    {
+        if (detectionMode != newMode)
+            std::fill(envelopes.begin(), envelopes.end(), SampleType(0));
+
+        detectionMode = newMode;
+    }
+
+    void setLevelDetector(LevelDetector newDetector)
+    {
+        if (levelDetector != newDetector)
+            std::fill(envelopes.begin(), envelopes.end(), SampleType(0));
+
+        levelDetector = newDetector;
+        updateGainComputer();
+    }
+
+    /** The update countdown keeps running across calls, so a threshold moved every block
+        still steps every updateInterval samples, whatever the block size. */
+    void setThreshold(SampleType newThresholdDb)
+    {
+        if (targetThresholdDb == newThresholdDb)
+            return;
+
+        targetThresholdDb = newThresholdDb;
+        thresholdStep = (targetThresholdDb - thresholdDb) / static_cast<SampleType>(glideUpdates);
+        remainingUpdates = glideUpdates;
+    }
+
+    void setRatio(SampleType newRatio)             { jassert(newRatio >= 1); slope = SampleType(1) / newRatio - SampleType(1); }
+    void setKnee(SampleType newKneeDb)             { jassert(newKneeDb >= 0); kneeDb = newKneeDb; updateGainComputer(); }
+    void setAttack(SampleType newAttackMs)         { attackMs = newAttackMs; updateBallistics(); }
+    void setRelease(SampleType newReleaseMs)       { releaseMs = newReleaseMs; updateBallistics(); }
+
+    /** A bypassed band still runs through the delay, so it lines up with the others. */
+    void setBypassed(bool shouldBeBypassed)        { bypassed = shouldBeBypassed; }
+
+    /** With a key, the detector listens to it instead of the band itself. A key with one
+        channel per band channel is followed like the band would be; any other key drives
+        one envelope for all channels from its loudest channel. */
+    void process(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>* key = nullptr)
+    {
+        auto numSamples = buffer.getNumSamples();
+        auto bufferChannels = buffer.getNumChannels();
+
+        const auto& detector = key != nullptr ? *key : buffer;
+        auto numDetectorChannels = detector.getNumChannels();
+
+        jassert(bufferChannels <= delayLine.getNumChannels());
+        jassert(detector.getNumSamples() >= numSamples);
+
+        auto mode = getEffectiveMode(bufferChannels, numDetectorChannels);
+
+        if (mode != lastMode)
+        {
+            std::fill(envelopes.begin(), envelopes.end(), SampleType(0));
+            lastMode = mode;
+        }
+
+        auto numEnvelopes = mode == DetectionMode::unlinked ? bufferChannels
+                          : mode == DetectionMode::midSide  ? 2
+                                                            : 1;
+
+        auto* const* data = buffer.getArrayOfWritePointers();
+        auto* const* detect = detector.getArrayOfReadPointers();
+        hasPlayed = true;
+
+        SampleType inputPeak = 0, outputPeak = 0, minGain = 1;
+        auto inputSquares = 0.0, outputSquares = 0.0;
+
+        for (auto start = 0; start < numSamples; start += rowLength)
+        {
+            auto length = juce::jmin(rowLength, numSamples - start);
+
+            //the detector is read before the band samples it may alias are overwritten
+            if (bypassed)
+            {
+                advanceThreshold(length);
+            }
+            else
+            {
+                if (levelDetector == LevelDetector::peak)
+                    readDetector(mode, detect, numDetectorChannels, numEnvelopes, start, length, [](SampleType x) { return std::abs(x); });
+                else
+                    readDetector(mode, detect, numDetectorChannels, numEnvelopes, start, length, [](SampleType x) { return x * x; });
+
+                followEnvelopes(numEnvelopes, length);
+                computeGains(numEnvelopes, length);
+
+                for (auto e = 0; e < numEnvelopes; ++e)
+                    minGain = juce::jmin(minGain, juce::FloatVectorOperations::findMinimum(getRow(e), length));
+            }
+
+            for (auto ch = 0; ch < bufferChannels; ++ch)
+                accumulateLevels(data[ch] + start, length, inputPeak, inputSquares);
+
+            applyGains(data, mode, bufferChannels, start, length);
+
+            for (auto ch = 0; ch < bufferChannels; ++ch)
+                accumulateLevels(data[ch] + start, length, outputPeak, outputSquares);
+        }
+
+        for (auto& e : envelopes)
+            juce::dsp::util::snapToZero(e);
+
+        auto numValues = static_cast<double>(juce::jmax(1, numSamples * bufferChannels));
+        levels.inputPeak = static_cast<float>(inputPeak);
+        levels.outputPeak = static_cast<float>(outputPeak);
+        levels.inputRms = static_cast<float>(std::sqrt(inputSquares / numValues));
+        levels.outputRms = static_cast<float>(std::sqrt(outputSquares / numValues));
+        levels.gainReductionDb = FastMath::gainToDecibels(static_cast<float>(minGain), -100.f);
+    }
+
+    /** Levels of the last processed block. */
+    const BandLevels& getLevels() const { return levels; }
+
+private:
+    static constexpr size_t vecSize = Vec::SIMDNumElements;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    DetectionMode detectionMode = DetectionMode::unlinked;
+    DetectionMode lastMode = DetectionMode::unlinked;
+    LevelDetector levelDetector = LevelDetector::peak;
+    bool bypassed = false;
+
+    SampleType attackMs = 50, releaseMs = 250;
+    SampleType attackCoefficient = 0, releaseCoefficient = 0;
+
+    SampleType thresholdDb = 0, kneeDb = 0, slope = 0;
+    SampleType targetThresholdDb = 0, thresholdStep = 0;
+    int glideUpdates = 1, remainingUpdates = 0, samplesToUpdate = updateInterval;
+    SampleType decibelsPerLog2 = 0, kneeStartLevel = 0, kneeScale = 0;
+
+    std::vector<SampleType> envelopes;
+
+    //one row per envelope: its detector level, then its envelope, then its gain
+    juce::HeapBlock<char> rowStorage;
+    SampleType* rows = nullptr;
+    int rowLength = 0;
+
+    juce::AudioBuffer<SampleType> delayLine;
+    int writeIndex = 0;
+    int lookaheadSamples = 0;
+    int maxLookahead = 0;
+
+    //the delayed input while the lookahead crossfades, see setLookahead
+    juce::AudioBuffer<SampleType> fadeBuffer;
+    int fadeFromLookahead = 0, lookaheadFadeLength = 1, lookaheadFadeRemaining = 0;
+    bool hasPlayed = false;
+
+    BandLevels levels;
+
+    /** Mono has nothing to link, and a key laid out differently can only drive one envelope. */
+    DetectionMode getEffectiveMode(int bufferChannels, int detectorChannels) const
+    {
+        if (detectorChannels != bufferChannels)
+            return DetectionMode::linked;
+
+        if (bufferChannels == 1 || (detectionMode == DetectionMode::midSide && bufferChannels != 2))
+            return DetectionMode::unlinked;
+
+        return detectionMode;
+    }
+
+    SampleType* getRow(int envelope) const { return rows + envelope * rowLength; }
+
+    /** |x| or x^2 of what each envelope follows, into its row. */
+    template <typename LevelFunction>
+    void readDetector(DetectionMode mode, const SampleType* const* detect, int numDetectorChannels,
+                      int numEnvelopes, int start, int length, LevelFunction level) const
+    {
+        if (mode == DetectionMode::linked)
+        {
+            //the loudest channel
+            auto* row = getRow(0);
+            std::fill(row, row + length, SampleType(0));
+
+            for (auto ch = 0; ch < numDetectorChannels; ++ch)
+            {
+                auto* x = detect[ch] + start;
+
+                for (auto i = 0; i < length; ++i)
+                    row[i] = juce::jmax(row[i], level(x[i]));
+            }
+        }
+        else if (mode == DetectionMode::midSide)
+        {
+            auto* mid = getRow(0);
+            auto* side = getRow(1);
+            auto* left = detect[0] + start;
+            auto* right = detect[1] + start;
+
+            for (auto i = 0; i < length; ++i)
+            {
+                mid[i] = level(SampleType(0.5) * (left[i] + right[i]));
+                side[i] = level(SampleType(0.5) * (left[i] - right[i]));
+            }
+        }
+        else
+        {
+            for (auto e = 0; e < numEnvelopes; ++e)
+            {
+                auto* row = getRow(e);
+                auto* x = detect[e] + start;
+
+                for (auto i = 0; i < length; ++i)
+                    row[i] = level(x[i]);
+            }
+        }
+    }
+
+    /** The one recursive stage, a sample at a time; levels in, envelopes out. Two
+        envelopes go through together where there are two, so their chains overlap. */
+    void followEnvelopes(int numEnvelopes, int length)
+    {
+        //both updates are always computed. Rising, the faster coefficient gives the larger
+        //result and falling the smaller one, so with the faster attack the one to keep is
+        //the larger of the two, whichever way the level went, and with the slower attack
+        //the smaller. A max or min instead of a comparison keeps the loop free of branches
+        auto keepLarger = attackCoefficient <= releaseCoefficient;
+        auto e = 0;
+
+        for (; e + 1 < numEnvelopes; e += 2)
+        {
+            if (keepLarger)
+                followEnvelopes<2>(e, length, [](SampleType a, SampleType b) { return juce::jmax(a, b); });
+            else
+                followEnvelopes<2>(e, length, [](SampleType a, SampleType b) { return juce::jmin(a, b); });
+        }
+
+        if (e < numEnvelopes)
+        {
+            if (keepLarger)
+                followEnvelopes<1>(e, length, [](SampleType a, SampleType b) { return juce::jmax(a, b); });
+            else
+                followEnvelopes<1>(e, length, [](SampleType a, SampleType b) { return juce::jmin(a, b); });
+        }
+    }
+
+    template <int numAtOnce, typename Select>
+    void followEnvelopes(int first, int length, Select select)
+    {
+        SampleType* row[numAtOnce];
+        SampleType envelope[numAtOnce];
+
+        for (auto k = 0; k < numAtOnce; ++k)
+        {
+            row[k] = getRow(first + k);
+            envelope[k] = envelopes[static_cast<size_t>(first + k)];
+        }
+
+        //BallisticsFilter's level + c (envelope - level), rearranged so only one multiply
+        //and one add wait on the previous sample
+        const auto attack = attackCoefficient, attackInput = SampleType(1) - attackCoefficient;
+        const auto release = releaseCoefficient, releaseInput = SampleType(1) - releaseCoefficient;
+
+        for (auto i = 0; i < length; ++i)
+        {
+            for (auto k = 0; k < numAtOnce; ++k)
+            {
+                auto level = row[k][i];
+                envelope[k] = select(attack * envelope[k] + attackInput * level, release * envelope[k] + releaseInput * level);
+                row[k][i] = envelope[k];
+            }
+        }
+
+        for (auto k = 0; k < numAtOnce; ++k)
+            envelopes[static_cast<size_t>(first + k)] = envelope[k];
+    }
+
+    /** The gain computer's settings as registers, copied out so that storing the gains
+        doesn't make the compiler load them again. */
+    struct GainComputer
+    {
+        Vec kneeStartLevel, thresholdDb, halfKneeDb, kneeDb, kneeScale, slope, decibelsPerLog2;
+    };
+
+    GainComputer getGainComputer() const
+    {
+        return { Vec::expand(kneeStartLevel), Vec::expand(thresholdDb), Vec::expand(SampleType(0.5) * kneeDb), Vec::expand(kneeDb),
+                 Vec::expand(kneeScale), Vec::expand(slope), Vec::expand(decibelsPerLog2) };
+    }
+
+    /** Envelopes in, gains out, a register of consecutive samples at a time. The rows
+        are whole registers long, so past the end it works on stale values nobody reads. */
+    void computeGains(int numEnvelopes, int length)
+    {
+        //quiet passages stay under the knee and need no logarithms at all. That is decided
+        //once for the block, which keeps the loop below free of branches
+        if (remainingUpdates == 0 && staysBelowKnee(numEnvelopes, length))
+        {
+            for (auto e = 0; e < numEnvelopes; ++e)
+                juce::FloatVectorOperations::fill(getRow(e), SampleType(1), length);
+
+            return;
+        }
+
+        auto computer = getGainComputer();
+
+        for (auto i = 0; i < length; i += static_cast<int>(vecSize))
+        {
+            if (advanceThreshold(juce::jmin(static_cast<int>(vecSize), length - i)))
+                computer = getGainComputer();
+
+            for (auto e = 0; e < numEnvelopes; ++e)
+            {
+                auto* gains = getRow(e) + i;
+                computeGains(computer, Vec::fromRawArray(gains)).copyToRawArray(gains);
+            }
+        }
+    }
+
+    bool staysBelowKnee(int numEnvelopes, int length)
+    {
+        for (auto e = 0; e < numEnvelopes; ++e)
+            if (juce::FloatVectorOperations::findMaximum(getRow(e), length) > kneeStartLevel)
+                return false;
+
+        return true;
+    }
+
+    /** Under the knee this comes out as exactly 1: no reduction, and exp2(0) is exact. */
+    static Vec computeGains(const GainComputer& c, Vec envelope)
+    {
+        auto over = FastMath::log2(envelope) * c.decibelsPerLog2 - c.thresholdDb;
+        auto t = Vec::min(Vec::max(over + c.halfKneeDb, Vec::expand(0)), c.kneeDb);
+        auto reductionDb = (t * t * c.kneeScale + Vec::max(over - c.halfKneeDb, Vec::expand(0))) * c.slope;
+
+        //back to a gain: 20 log10 g = 6.02 log2 g
+        return FastMath::exp2(reductionDb * (SampleType(1) / amplitudeDecibelsPerLog2));
+    }
+
+    /** Puts the block through the delay line, with the gains of the rows once it comes out. */
+    void applyGains(SampleType* const* data, DetectionMode mode, int bufferChannels, int start, int length)
+    {
+        auto* const* delayed = delayLine.getArrayOfWritePointers();
+        auto delayLength = delayLine.getNumSamples();
+
+        //all of it goes in first; the line is long enough that nothing still to be read is overwritten
+        for (auto ch = 0; ch < bufferChannels; ++ch)
+        {
+            auto firstPart = juce::jmin(length, delayLength - writeIndex);
+            juce::FloatVectorOperations::copy(delayed[ch] + writeIndex, data[ch] + start, firstPart);
+            juce::FloatVectorOperations::copy(delayed[ch], data[ch] + start + firstPart, length - firstPart);
+        }
+
+        auto readIndex = writeIndex - lookaheadSamples;
+        if (readIndex < 0)
+            readIndex += delayLength;
+
+        if (lookaheadFadeRemaining > 0)
+        {
+            auto fadeIndex = writeIndex - fadeFromLookahead;
+            if (fadeIndex < 0)
+                fadeIndex += delayLength;
+
+            writeIndex = (writeIndex + length) % delayLength;
+
+            readCrossfade(delayed, bufferChannels, fadeIndex, readIndex, length);
+            applyGainsToRun(data, fadeBuffer.getArrayOfWritePointers(), mode, bufferChannels, start, 0, 0, length);
+            return;
+        }
+
+        writeIndex = (writeIndex + length) % delayLength;
+
+        //in at most two runs, split where the read position wraps
+        for (auto done = 0; done < length;)
+        {
+            auto runLength = juce::jmin(length - done, delayLength - readIndex);
+            applyGainsToRun(data, delayed, mode, bufferChannels, start + done, readIndex, done, runLength);
+
+            done += runLength;
+            readIndex = (readIndex + runLength) % delayLength;
+        }
+    }
+
+    /** The delayed input into fadeBuffer, moving from the old read position to the new
+        one along a linear ramp that carries on across blocks. */
+    void readCrossfade(SampleType* const* delayed, int bufferChannels, int oldIndex, int newIndex, int length)
+    {
+        auto delayLength = delayLine.getNumSamples();
+        auto step = SampleType(1) / static_cast<SampleType>(lookaheadFadeLength);
+        auto done = static_cast<SampleType>(lookaheadFadeLength - lookaheadFadeRemaining);
+
+        for (auto ch = 0; ch < bufferChannels; ++ch)
+        {
+            auto* out = fadeBuffer.getWritePointer(ch);
+            auto from = oldIndex, to = newIndex;
+
+            for (auto i = 0; i < length; ++i)
+            {
+                auto t = juce::jmin(SampleType(1), (done + static_cast<SampleType>(i + 1)) * step);
+                out[i] = delayed[ch][from] + t * (delayed[ch][to] - delayed[ch][from]);
+
+                if (++from == delayLength)
+                    from = 0;
+
+                if (++to == delayLength)
+                    to = 0;
+            }
+        }
+
+        lookaheadFadeRemaining = juce::jmax(0, lookaheadFadeRemaining - length);
+    }
+
+    void applyGainsToRun(SampleType* const* data, SampleType* const* delayed, DetectionMode mode,
+                         int bufferChannels, int start, int readIndex, int rowIndex, int length) const
+    {
+        if (bypassed)
+        {
+            for (auto ch = 0; ch < bufferChannels; ++ch)
+                juce::FloatVectorOperations::copy(data[ch] + start, delayed[ch] + readIndex, length);
+        }
+        else if (mode == DetectionMode::midSide)
+        {
+            auto* left = delayed[0] + readIndex;
+            auto* right = delayed[1] + readIndex;
+            auto* midGains = getRow(0) + rowIndex;
+            auto* sideGains = getRow(1) + rowIndex;
+            auto* outLeft = data[0] + start;
+            auto* outRight = data[1] + start;
+
+            for (auto i = 0; i < length; ++i)
+            {
+                auto mid = SampleType(0.5) * (left[i] + right[i]) * midGains[i];
+                auto side = SampleType(0.5) * (left[i] - right[i]) * sideGains[i];
+                outLeft[i] = mid + side;
+                outRight[i] = mid - side;
+            }
+        }
+        else
+        {
+            for (auto ch = 0; ch < bufferChannels; ++ch)
+                juce::FloatVectorOperations::multiply(data[ch] + start, delayed[ch] + readIndex,
+                                                      getRow(mode == DetectionMode::linked ? 0 : ch) + rowIndex, length);
+        }
+    }
+
+    /** Peak and sum of squares for the meters. Four running sums, so the adds don't wait
+        on each other and the loop vectorises. */
+    static void accumulateLevels(const SampleType* x, int length, SampleType& peak, double& squares)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(x, length);
+        peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+
+        SampleType sums[4] {};
+        auto i = 0;
+
+        for (; i + 4 <= length; i += 4)
+            for (auto l = 0; l < 4; ++l)
+                sums[l] += x[i + l] * x[i + l];
+
+        for (; i < length; ++i)
+            sums[0] += x[i] * x[i];
+
+        squares += static_cast<double>(sums[0] + sums[1] + sums[2] + sums[3]);
+    }
+
+    static constexpr SampleType amplitudeDecibelsPerLog2 = FastMath::decibelsPerLog2<SampleType>;
+
+    /** Counts the samples down to the next glide step, and takes the steps that are due.
+        Returns true if the threshold moved. */
+    bool advanceThreshold(int numSamples)
+    {
+        if (remainingUpdates == 0)
+            return false;
+
+        samplesToUpdate -= numSamples;
+
+        if (samplesToUpdate > 0)
+            return false;
+
+        while (remainingUpdates > 0 && samplesToUpdate <= 0)
+            stepThreshold();
+
+        return true;
+    }
+
+    void stepThreshold()
+    {
+        //the last step lands exactly on the target
+        thresholdDb = --remainingUpdates == 0 ? targetThresholdDb : thresholdDb + thresholdStep;
+        samplesToUpdate += updateInterval;
+        updateGainComputer();
+    }
+
+    void updateGainComputer()
+    {
+        //a smoothed power reads as 10 log10, a smoothed amplitude as 20 log10
+        decibelsPerLog2 = levelDetector == LevelDetector::rms ? SampleType(0.5) * amplitudeDecibelsPerLog2
+                                                              : amplitudeDecibelsPerLog2;
+
+        auto kneeStartDb = thresholdDb - SampleType(0.5) * kneeDb;
+        kneeStartLevel = std::exp2(kneeStartDb / decibelsPerLog2);
+        kneeScale = kneeDb > 0 ? SampleType(0.5) / kneeDb : SampleType(0);
+    }
+
+    void updateBallistics()
+    {
+        //juce::dsp::BallisticsFilter's coefficients, so the times read the same as before
+        auto expFactor = -2.0 * juce::MathConstants<double>::pi * 1000.0 / sampleRate;
+        auto coefficient = [expFactor](SampleType ms)
+        {
+            return ms < SampleType(1.0e-3) ? SampleType(0) : static_cast<SampleType>(std::exp(expFactor / ms));
+        };
+
+        attackCoefficient = coefficient(attackMs);
+        releaseCoefficient = coefficient(releaseMs);
+    }
+};
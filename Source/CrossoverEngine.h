@@ -0,0 +1,591 @@
+/*
+  ==============================================================================
+
+    CrossoverEngine.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+/** Linkwitz-Riley orders; the values are the Crossover Slope choice indices. */
+enum class CrossoverOrder
+{
+    lr2,        // 12 dB/oct, first order sections, the high band comes out inverted
+    lr4,        // 24 dB/oct
+    lr8         // 48 dB/oct
+};
+
+/*
+    Linkwitz-Riley band splitter that runs the whole crossover tree in SIMD registers.
+
+    Every band of every channel owns one lane. All lanes run the same sequence of
+    state-variable stages, and a per-lane mask picks which output of each stage the
+    lane keeps. That way the LP, HP and AP branches of a crossover point, for all
+    channels, are a single vector operation:
+
+         fc0      fc1
+      x - LP1 --- AP2 ---> low
+        \ HP1 -+- LP2 ---> mid
+               \ HP2 ---> high
+
+    With more bands the tree grows the same way: band b is the LP of crossover b
+    (or the HP of the last one), fed through the all-passes of every crossover above
+    it so all bands stay phase aligned.
+
+    The per-stage maths is the TPT structure used by juce::dsp::LinkwitzRileyFilter,
+    so in LR4 the bands match the ones produced by separate filters. It runs in float or
+    double; a double register holds half the lanes, so the double engine needs twice the
+    registers.
+
+    A Linkwitz-Riley crossover of order 2N is a Butterworth filter of order N run twice.
+    Each order is a compile-time cascade of Butterworth sections: one first order section
+    for LR2, one state-variable section for LR4, two with their own damping for LR8. The
+    first pass through the sections also yields the Butterworth allpass, which is what
+    the lanes below the crossover get in place of a separate AP filter; in the second pass
+    those lanes go through untouched. The cascades are unrolled per order, and an order's
+    states are packed lane-contiguous per register, so LR8 moves twice the state of LR4
+    once per block rather than every sample.
+
+    A new crossover frequency is glided to rather than jumped to. Every updateInterval
+    samples g is multiplied by a fixed ratio, so the cutoff sweeps evenly in log frequency,
+    and only h is recomputed. g = tan(pi fc / fs) itself comes from a table that prepare()
+    fills for the sample rate, so a modulated cutoff costs a lookup and a few multiplies
+    rather than tan() and pow(). The TPT states don't depend on the coefficients, so
+    they carry over a change unscaled and the filter stays stable while it moves.
+*/
+template <size_t NumBands, typename SampleType = float>
+class CrossoverEngine
+{
+public:
+    static constexpr size_t numBands = NumBands;
+    static constexpr size_t numCrossovers = numBands - 1;
+
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    using Mask = typename Vec::vMaskType;
+    using MaskElement = typename Mask::ElementType;
+    using BandBuffers = std::array<juce::AudioBuffer<SampleType>, numBands>;
+
+    static constexpr int updateInterval = 32;
+    static constexpr double glideSeconds = 0.05;
+
+    static constexpr float maxCutoff = 20000.f;     // top of the crossover parameter range
+    static constexpr size_t gTableSize = 1024;
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+        numChannels = static_cast<size_t>(spec.numChannels);
+        numRegisters = (numChannels * lanesPerChannel + vecSize - 1) / vecSize;
+
+        zeros.assign(spec.maximumBlockSize, SampleType(0));
+        segments.resize(spec.maximumBlockSize / updateInterval + 2);
+        glideUpdates = juce::jmax(1, juce::roundToInt(glideSeconds * sampleRate / updateInterval));
+        fillGTable();
+
+        stateStorage.allocate(numRegisters * statesPerRegister * vecSize * sizeof(SampleType) + Vec::SIMDRegisterSize, true);
+        states = juce::snapPointerToAlignment(reinterpret_cast<SampleType*>(stateStorage.getData()), Vec::SIMDRegisterSize);
+
+        fadeStateStorage.allocate(numRegisters * statesPerRegister * vecSize * sizeof(SampleType) + Vec::SIMDRegisterSize, true);
+        fadeStates = juce::snapPointerToAlignment(reinterpret_cast<SampleType*>(fadeStateStorage.getData()), Vec::SIMDRegisterSize);
+
+        for (auto& b : fadeBands)
+            b.setSize(static_cast<int>(numChannels), static_cast<int>(spec.maximumBlockSize));
+
+        fadingOut = false;
+
+        maskStorage.allocate(numRegisters * masksPerRegister * vecSize * sizeof(MaskElement) + Vec::SIMDRegisterSize, true);
+        masks = juce::snapPointerToAlignment(reinterpret_cast<MaskElement*>(maskStorage.getData()), Vec::SIMDRegisterSize);
+
+        for (size_t r = 0; r < numRegisters; ++r)
+        {
+            for (size_t j = 0; j < numCrossovers; ++j)
+            {
+                auto* lowMask = getMask(r, j, keepLow);
+                auto* highMask = getMask(r, j, keepHigh);
+                auto* allpassMask = getMask(r, j, keepAllpass);
+
+                for (size_t l = 0; l < vecSize; ++l)
+                {
+                    auto band = (r * vecSize + l) % lanesPerChannel;
+                    auto isBand = band < numBands;
+
+                    lowMask[l] = isBand && band == j ? allBits : 0;
+                    highMask[l] = isBand && band > j ? allBits : 0;
+                    allpassMask[l] = isBand && band < j ? allBits : 0;
+                }
+            }
+        }
+
+        //a fresh engine starts at its cutoffs rather than gliding to them
+        for (size_t j = 0; j < numCrossovers; ++j)
+        {
+            targetG[j] = getG(cutoffs[j]);
+            coefficients[j] = makeCoefficients(order, targetG[j]);
+            remainingUpdates[j] = 0;
+        }
+
+        samplesToUpdate = updateInterval;
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(states, states + numRegisters * statesPerRegister * vecSize, SampleType(0));
+    }
+
+    /** The states of one cascade mean nothing to another, so a new order starts from
+        silence. Once prepared, the old order keeps running from its own states through
+        the next block and is crossfaded into the new one, so a change while playing
+        doesn't click. */
+    void setOrder(CrossoverOrder newOrder)
+    {
+        if (order == newOrder)
+            return;
+
+        //a second change before the fade has run keeps fading out the order that was playing
+        if (states != nullptr && ! fadingOut)
+        {
+            std::swap(states, fadeStates);
+            fadingOrder = order;
+            fadingOut = true;
+        }
+
+        order = newOrder;
+
+        for (auto& c : coefficients)
+            c = makeCoefficients(order, c.g);
+
+        reset();
+    }
+
+    void setCrossoverFrequency(size_t index, float frequency)
+    {
+        jassert(index < numCrossovers);
+
+        if (cutoffs[index] != frequency)
+        {
+            cutoffs[index] = frequency;
+            targetG[index] = getG(frequency);
+
+            //before the first prepare there is nothing to glide from
+            if (coefficients[index].g > 0)
+            {
+                glideRatio[index] = FastMath::exp2(FastMath::log2(targetG[index] / coefficients[index].g) / static_cast<SampleType>(glideUpdates));
+                remainingUpdates[index] = glideUpdates;
+            }
+        }
+    }
+
+    /** The input may have fewer channels than prepared for; registers holding none of its
+        channels are skipped, so spare capacity costs nothing until it's used. */
+    void process(const juce::AudioBuffer<SampleType>& input, BandBuffers& bands)
+    {
+        process(input, bands, [](int numTasks, auto& task)
+        {
+            for (auto i = 0; i < numTasks; ++i)
+                task(i);
+        });
+    }
+
+    /** The same split, with the registers handed out as tasks: runTasks(numTasks, task)
+        must call task(i) once for every i, in any order and on any thread, and return
+        when all are done. Registers hold separate lanes, so the tasks share nothing. */
+    template <typename TaskRunner>
+    void process(const juce::AudioBuffer<SampleType>& input, BandBuffers& bands, TaskRunner&& runTasks)
+    {
+        jassert(static_cast<size_t>(input.getNumChannels()) <= numChannels);
+        jassert(static_cast<size_t>(input.getNumSamples()) <= zeros.size());
+
+        auto numUsedRegisters = (static_cast<size_t>(input.getNumChannels()) * lanesPerChannel + vecSize - 1) / vecSize;
+        auto numSegments = planSegments(input.getNumSamples());
+
+        auto processTask = [this, &input, &bands, numSegments](int r)
+        {
+            processRegister(order, states, static_cast<size_t>(r), input, bands, numSegments);
+
+            if (fadingOut)
+                processRegister(fadingOrder, fadeStates, static_cast<size_t>(r), input, fadeBands, numSegments);
+        };
+
+        runTasks(static_cast<int>(numUsedRegisters), processTask);
+
+        if (fadingOut)
+        {
+            crossfadeFromOldOrder(bands, input.getNumChannels(), input.getNumSamples());
+            fadingOut = false;
+        }
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        for (size_t k = 0; k < numRegisters * statesPerRegister * vecSize; ++k)
+            juce::dsp::util::snapToZero(states[k]);
+       #endif
+    }
+
+private:
+    static constexpr size_t vecSize = Vec::SIMDNumElements;
+    static constexpr size_t lanesPerChannel = numBands <= 2 ? 2 : (numBands <= 4 ? 4 : 8);
+    static constexpr size_t channelsPerRegister = vecSize > lanesPerChannel ? vecSize / lanesPerChannel : 1;
+    static constexpr size_t maxSections = 2;
+    static constexpr size_t statesPerRegister = 4 * maxSections * numCrossovers;
+    static constexpr size_t masksPerRegister = 3 * numCrossovers;
+    static constexpr MaskElement allBits = static_cast<MaskElement>(-1);
+
+    static_assert(numBands >= 2 && numBands <= 8, "a channel must fit in the lane layout");
+
+    enum MaskType
+    {
+        keepLow,
+        keepHigh,
+        keepAllpass
+    };
+
+    static constexpr SampleType R2 = static_cast<SampleType>(1.4142135623730951);
+
+    /** The sections of one pass, and the states each one keeps, for an order. */
+    template <CrossoverOrder Order>
+    struct Cascade
+    {
+        static constexpr size_t numSections = Order == CrossoverOrder::lr8 ? 2 : 1;
+        static constexpr size_t statesPerSection = Order == CrossoverOrder::lr2 ? 1 : 2;
+        static constexpr size_t numStates = 2 * numSections * statesPerSection;
+    };
+
+    /** 1 / Q of state-variable section k: 2 cos(pi / 8) and 2 cos(3 pi / 8) for the 4th order Butterworth of LR8. */
+    static constexpr SampleType getDamping(CrossoverOrder s, size_t k)
+    {
+        if (s != CrossoverOrder::lr8)
+            return R2;
+
+        return static_cast<SampleType>(k == 0 ? 1.8477590650225735 : 0.7653668647301796);
+    }
+
+    static constexpr size_t getNumSections(CrossoverOrder s) { return s == CrossoverOrder::lr8 ? 2 : 1; }
+
+    /** h per section; a first order section keeps g / (1 + g) there instead. */
+    struct Coefficients
+    {
+        SampleType g = 0;
+        std::array<SampleType, maxSections> h {};
+    };
+
+    /** A stretch of the block that runs with one set of coefficients. */
+    struct Segment
+    {
+        int numSamples = 0;
+        std::array<Coefficients, numCrossovers> coefficients;
+    };
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0;
+    size_t numRegisters = 0;
+
+    CrossoverOrder order = CrossoverOrder::lr4;
+
+    //the order being faded out after setOrder, with its states and band outputs
+    CrossoverOrder fadingOrder = CrossoverOrder::lr4;
+    bool fadingOut = false;
+    BandBuffers fadeBands;
+    std::array<float, numCrossovers> cutoffs = getDefaultCutoffs();
+    std::array<Coefficients, numCrossovers> coefficients;
+
+    std::array<SampleType, numCrossovers> targetG {}, glideRatio {};
+    std::array<int, numCrossovers> remainingUpdates {};
+    int glideUpdates = 1;
+    std::vector<double> gTable;
+    double gTableStep = 1.0, gSlopeScale = 0.0;
+    int samplesToUpdate = updateInterval;
+    std::vector<Segment> segments;
+
+    juce::HeapBlock<char> stateStorage, fadeStateStorage, maskStorage;
+    SampleType* states = nullptr;
+    SampleType* fadeStates = nullptr;
+    MaskElement* masks = nullptr;
+    std::vector<SampleType> zeros;
+
+    template <CrossoverOrder Order>
+    static SampleType* getState(SampleType* base, size_t reg, size_t crossover, size_t index)
+    {
+        return base + ((reg * numCrossovers + crossover) * Cascade<Order>::numStates + index) * vecSize;
+    }
+
+    MaskElement* getMask(size_t reg, size_t crossover, MaskType type)
+    {
+        return masks + ((reg * numCrossovers + crossover) * 3 + type) * vecSize;
+    }
+
+    static std::array<float, numCrossovers> getDefaultCutoffs()
+    {
+        //log spaced between 20 Hz and 20 kHz; the owner sets the real values before processing
+        std::array<float, numCrossovers> c;
+        for (size_t j = 0; j < numCrossovers; ++j)
+            c[j] = 20.f * std::pow(1000.f, (j + 1.f) / numBands);
+
+        return c;
+    }
+
+    /** g on an even grid from 0 Hz to the top cutoff, which stays just below Nyquist at low sample rates. */
+    void fillGTable()
+    {
+        auto topCutoff = juce::jmin(static_cast<double>(maxCutoff), 0.49 * sampleRate);
+        gTableStep = topCutoff / (gTableSize - 1);
+        gSlopeScale = juce::MathConstants<double>::pi * gTableStep / sampleRate;
+
+        gTable.resize(gTableSize);
+        for (size_t k = 0; k < gTableSize; ++k)
+            gTable[k] = std::tan(juce::MathConstants<double>::pi * static_cast<double>(k) * gTableStep / sampleRate);
+    }
+
+    /** Cubic Hermite between table points. The slopes need no storage of their own:
+        d/df tan(pi f / fs) = pi / fs * (1 + g^2), so each point gives its own. */
+    SampleType getG(float cutoff) const
+    {
+        //before the first prepare; prepare() looks the cutoffs up again
+        if (gTable.empty())
+            return 0;
+
+        auto position = juce::jlimit(0.0, static_cast<double>(gTableSize - 1), cutoff / gTableStep);
+        auto k = juce::jmin(static_cast<size_t>(position), gTableSize - 2);
+        auto t = position - static_cast<double>(k);
+
+        auto g0 = gTable[k], g1 = gTable[k + 1];
+        auto m0 = gSlopeScale * (1.0 + g0 * g0), m1 = gSlopeScale * (1.0 + g1 * g1);
+
+        auto t2 = t * t, t3 = t2 * t;
+        auto g = (2 * t3 - 3 * t2 + 1) * g0 + (t3 - 2 * t2 + t) * m0 + (3 * t2 - 2 * t3) * g1 + (t3 - t2) * m1;
+
+        return static_cast<SampleType>(g);
+    }
+
+    static Coefficients makeCoefficients(CrossoverOrder o, SampleType g)
+    {
+        Coefficients c;
+        c.g = g;
+
+        if (o == CrossoverOrder::lr2)
+            c.h[0] = g / (SampleType(1) + g);
+        else
+            for (size_t k = 0; k < getNumSections(o); ++k)
+                c.h[k] = SampleType(1) / (SampleType(1) + getDamping(o, k) * g + g * g);
+
+        return c;
+    }
+
+    /** Calls f(std::integral_constant<size_t, n>()) for every n of the sequence, unrolled. */
+    template <size_t... N, typename Function>
+    static void unroll(std::index_sequence<N...>, Function&& f)
+    {
+        (f(std::integral_constant<size_t, N>()), ...);
+    }
+
+    bool isGliding() const
+    {
+        return std::any_of(remainingUpdates.begin(), remainingUpdates.end(), [](int n) { return n > 0; });
+    }
+
+    void processRegister(CrossoverOrder o, SampleType* base, size_t r, const juce::AudioBuffer<SampleType>& input,
+                         BandBuffers& bands, size_t numSegments)
+    {
+        switch (o)
+        {
+            case CrossoverOrder::lr2: processRegister<CrossoverOrder::lr2>(base, r, input, bands, numSegments); break;
+            case CrossoverOrder::lr4: processRegister<CrossoverOrder::lr4>(base, r, input, bands, numSegments); break;
+            case CrossoverOrder::lr8: processRegister<CrossoverOrder::lr8>(base, r, input, bands, numSegments); break;
+        }
+    }
+
+    /** Runs one register's lanes through the tree for the whole block. */
+    template <CrossoverOrder Order>
+    void processRegister(SampleType* base, size_t r, const juce::AudioBuffer<SampleType>& input, BandBuffers& bands, size_t numSegments)
+    {
+        using Stages = Cascade<Order>;
+        constexpr auto numSections = Stages::numSections;
+
+        std::array<const SampleType*, vecSize> src;
+        std::array<SampleType*, vecSize> dst;
+
+        for (size_t l = 0; l < vecSize; ++l)
+        {
+            auto lane = r * vecSize + l;
+            auto channel = static_cast<int>(lane / lanesPerChannel);
+            auto band = lane % lanesPerChannel;
+            auto hasChannel = channel < input.getNumChannels();
+
+            src[l] = hasChannel ? input.getReadPointer(channel) : zeros.data();
+            dst[l] = hasChannel && band < numBands ? bands[band].getWritePointer(channel) : nullptr;
+        }
+
+        std::array<std::array<Vec, Stages::numStates>, numCrossovers> s;
+        std::array<Mask, numCrossovers> lowMask, highMask, allpassMask;
+
+        for (size_t j = 0; j < numCrossovers; ++j)
+        {
+            for (size_t n = 0; n < Stages::numStates; ++n)
+                s[j][n] = Vec::fromRawArray(getState<Order>(base, r, j, n));
+
+            lowMask[j] = Mask::fromRawArray(getMask(r, j, keepLow));
+            highMask[j] = Mask::fromRawArray(getMask(r, j, keepHigh));
+            allpassMask[j] = Mask::fromRawArray(getMask(r, j, keepAllpass));
+        }
+
+        alignas(Vec::SIMDRegisterSize) SampleType lanes[vecSize];
+        std::array<Vec, numCrossovers> g;
+        std::array<std::array<Vec, numSections>, numCrossovers> Rg, h;
+        auto i = 0;
+
+        for (size_t k = 0; k < numSegments; ++k)
+        {
+            const auto& segment = segments[k];
+
+            for (size_t j = 0; j < numCrossovers; ++j)
+            {
+                //the segments hold h for the playing order; an order being faded out works out its own
+                auto c = Order == order ? segment.coefficients[j] : makeCoefficients(Order, segment.coefficients[j].g);
+                g[j] = Vec::expand(c.g);
+
+                for (size_t n = 0; n < numSections; ++n)
+                {
+                    Rg[j][n] = Vec::expand(getDamping(Order, n) + c.g);
+                    h[j][n] = Vec::expand(c.h[n]);
+                }
+            }
+
+            for (auto end = i + segment.numSamples; i < end; ++i)
+            {
+                Vec x;
+
+                if constexpr (channelsPerRegister == 1)
+                {
+                    x = Vec::expand(src[0][i]);
+                }
+                else
+                {
+                    for (size_t l = 0; l < vecSize; ++l)
+                        lanes[l] = src[l][i];
+
+                    x = Vec::fromRawArray(lanes);
+                }
+
+                for (size_t j = 0; j < numCrossovers; ++j)
+                {
+                    //every section of both passes; the first pass picks LP, HP or the allpass,
+                    //the second leaves the allpass lanes as they are
+                    unroll(std::make_index_sequence<2 * numSections>(), [&](auto stage)
+                    {
+                        constexpr auto firstPass = decltype(stage)::value < numSections;
+                        constexpr auto n = decltype(stage)::value % numSections;
+                        auto* state = s[j].data() + decltype(stage)::value * Stages::statesPerSection;
+
+                        if constexpr (Order == CrossoverOrder::lr2)
+                        {
+                            auto v = (x - state[0]) * h[j][n];
+                            auto yL = v + state[0];
+                            state[0] = yL + v;
+                            auto yH = x - yL;
+
+                            //LP^2 - HP^2 is the first order allpass, so the high lanes invert
+                            if constexpr (firstPass)
+                                x = (yL & lowMask[j]) + (yH & highMask[j]) + ((yL - yH) & allpassMask[j]);
+                            else
+                                x = (yL & lowMask[j]) - (yH & highMask[j]) + (x & allpassMask[j]);
+                        }
+                        else
+                        {
+                            auto yH = (x - Rg[j][n] * state[0] - state[1]) * h[j][n];
+                            auto yB = g[j] * yH + state[0];
+                            state[0] = g[j] * yH + yB;
+                            auto yL = g[j] * yB + state[1];
+                            state[1] = g[j] * yB + yL;
+
+                            if constexpr (firstPass)
+                            {
+                                auto yA = yL - yB * getDamping(Order, n) + yH;
+                                x = (yL & lowMask[j]) + (yH & highMask[j]) + (yA & allpassMask[j]);
+                            }
+                            else
+                            {
+                                x = (yL & lowMask[j]) + (yH & highMask[j]) + (x & allpassMask[j]);
+                            }
+                        }
+                    });
+                }
+
+                x.copyToRawArray(lanes);
+
+                for (size_t l = 0; l < vecSize; ++l)
+                {
+                    if (dst[l] != nullptr)
+                        dst[l][i] = lanes[l];
+                }
+            }
+        }
+
+        for (size_t j = 0; j < numCrossovers; ++j)
+            for (size_t n = 0; n < Stages::numStates; ++n)
+                s[j][n].copyToRawArray(getState<Order>(base, r, j, n));
+    }
+
+    /** A linear ramp over the block from the old order's bands to the new order's. */
+    void crossfadeFromOldOrder(BandBuffers& bands, int numUsedChannels, int numSamples)
+    {
+        auto step = SampleType(1) / static_cast<SampleType>(juce::jmax(1, numSamples));
+
+        for (size_t b = 0; b < numBands; ++b)
+        {
+            for (auto ch = 0; ch < numUsedChannels; ++ch)
+            {
+                auto* y = bands[b].getWritePointer(ch);
+                auto* old = fadeBands[b].getReadPointer(ch);
+
+                for (auto i = 0; i < numSamples; ++i)
+                    y[i] = old[i] + static_cast<SampleType>(i + 1) * step * (y[i] - old[i]);
+            }
+        }
+    }
+
+    /** Splits the block where the coefficients step and returns the number of segments.
+        The steps keep their spacing across blocks, so the glide doesn't depend on the
+        block size; without a glide the whole block is one segment. */
+    size_t planSegments(int numSamples)
+    {
+        size_t numSegments = 0;
+
+        for (auto start = 0; start < numSamples;)
+        {
+            auto gliding = isGliding();
+            auto length = gliding ? juce::jmin(samplesToUpdate, numSamples - start) : numSamples - start;
+
+            auto& segment = segments[numSegments++];
+            segment.numSamples = length;
+            segment.coefficients = coefficients;
+            start += length;
+
+            if (! gliding)
+                break;
+
+            samplesToUpdate -= length;
+
+            if (samplesToUpdate == 0)
+            {
+                samplesToUpdate = updateInterval;
+
+                for (size_t j = 0; j < numCrossovers; ++j)
+                {
+                    if (remainingUpdates[j] > 0)
+                    {
+                        //the last step lands exactly on the target
+                        auto g = --remainingUpdates[j] == 0 ? targetG[j] : coefficients[j].g * glideRatio[j];
+                        coefficients[j] = makeCoefficients(order, g);
+                    }
+                }
+            }
+        }
+
+        return numSegments;
+    }
+};
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef SIMPLEMBCOMP_EXACT_MATH
+ #define SIMPLEMBCOMP_EXACT_MATH 0
+#endif
+
+/*
+    log2 and exp2 for the gain computer and the meters, which convert between gain and
+    dB on every sample. The float's exponent is taken from its bits and only the
+    mantissa goes through a polynomial, so there are no branches and no library calls,
+    and a loop over SIMD lanes vectorises.
+
+        log2   5th order on the mantissa, exact at powers of two    |error| < 5.1e-5
+        exp2   5th order on the fraction, exact at integers             relative < 3e-7
+
+    The exp2 polynomial itself is good to 2.2e-7; in float, rounding in the Horner steps
+    adds the rest. A gain to dB and back is off by less than 0.0004 dB. The fast_math
+    benchmark suite measures both directions and fails if either is off by 0.01 dB.
+
+    The polynomials are sized for float. A host that asks for double precision is asking
+    for more than they give, so doubles always go through std::log2 and std::exp2, as
+    does everything when built with SIMPLEMBCOMP_EXACT_MATH=1 for reference renders.
+*/
+namespace FastMath
+{
+namespace detail
+{
+template <typename FloatType> struct FloatBits;
+
+template <> struct FloatBits<float>
+{
+    using Int = uint32_t;
+    static constexpr int mantissaBits = 23;
+    static constexpr int bias = 127;
+};
+
+template <> struct FloatBits<double>
+{
+    using Int = uint64_t;
+    static constexpr int mantissaBits = 52;
+    static constexpr int bias = 1023;
+};
+
+template <typename To, typename From>
+To bitCast(From value)
+{
+    static_assert(sizeof(To) == sizeof(From), "bit casts keep the size");
+    To result;
+    std::memcpy(&result, &value, sizeof(To));
+    return result;
+}
+
+template <typename FloatType>
+constexpr bool usesLibraryMath = SIMPLEMBCOMP_EXACT_MATH != 0 || std::is_same_v<FloatType, double>;
+}
+
+/** 20 log10(x) = decibelsPerLog2 * log2(x) */
+template <typename FloatType>
+constexpr FloatType decibelsPerLog2 = static_cast<FloatType>(6.020599913279624);
+
+namespace detail
+{
+/*
+    The polynomial kernels without the clamps, as straight-line code. A conditional
+    with floating point arithmetic in it would keep a loop over these from vectorising
+    under the default strict floating point model, so there is none.
+*/
+
+/** x positive and normal. */
+template <typename FloatType>
+inline FloatType log2Kernel(FloatType x)
+{
+    using Bits = FloatBits<FloatType>;
+    using Int = typename Bits::Int;
+
+    constexpr auto mantissaMask = (Int(1) << Bits::mantissaBits) - 1;
+    constexpr auto oneBits = Int(Bits::bias) << Bits::mantissaBits;
+
+    auto bits = bitCast<Int>(x);
+    auto exponent = static_cast<FloatType>(static_cast<int>(bits >> Bits::mantissaBits) - Bits::bias);
+    auto u = bitCast<FloatType>((bits & mantissaMask) | oneBits) - FloatType(1);
+
+    //log2(1 + u) / u on [0, 1), fitted at Chebyshev nodes
+    auto p = static_cast<FloatType>(0.0586649397156539);
+    p = p * u + static_cast<FloatType>(-0.22510302549827224);
+    p = p * u + static_cast<FloatType>(0.44059903295532005);
+    p = p * u + static_cast<FloatType>(-0.7167146631676422);
+    p = p * u + static_cast<FloatType>(1.4426038942423591);
+
+    return exponent + u * p;
+}
+
+/** |x| <= exp2Limit. */
+template <typename FloatType>
+inline FloatType exp2Kernel(FloatType x)
+{
+    using Bits = FloatBits<FloatType>;
+    using Int = typename Bits::Int;
+
+    //floor, as truncation less one below zero; a library call would stop vectorisation too
+    auto truncated = static_cast<int>(x);
+    auto whole = truncated - static_cast<int>(x < static_cast<FloatType>(truncated));
+    auto f = x - static_cast<FloatType>(whole);
+    auto scale = bitCast<FloatType>(static_cast<Int>(whole + Bits::bias) << Bits::mantissaBits);
+
+    //(2^f - 1) / f on [0, 1), fitted at Chebyshev nodes; the leading 1 is kept exact so exp2(0) is unity gain
+    auto p = static_cast<FloatType>(0.0017883687415289483);
+    p = p * f + static_cast<FloatType>(0.00919938759954215);
+    p = p * f + static_cast<FloatType>(0.05565705438618287);
+    p = p * f + static_cast<FloatType>(0.24020719419078534);
+    p = p * f + static_cast<FloatType>(0.6931475675579636);
+    p = FloatType(1) + f * p;
+
+    return scale * p;
+}
+
+template <typename FloatType>
+constexpr FloatType exp2Limit = static_cast<FloatType>(FloatBits<FloatType>::bias - 1);
+}
+
+/** x > 0; zero and denormals read as the smallest normal number. */
+template <typename FloatType>
+inline FloatType log2(FloatType x)
+{
+    x = juce::jmax(x, std::numeric_limits<FloatType>::min());
+
+    if constexpr (detail::usesLibraryMath<FloatType>)
+        return std::log2(x);
+    else
+        return detail::log2Kernel(x);
+}
+
+/** Clamped to the normal range, so very negative inputs give a tiny gain rather than zero. */
+template <typename FloatType>
+inline FloatType exp2(FloatType x)
+{
+    x = juce::jlimit(-detail::exp2Limit<FloatType>, detail::exp2Limit<FloatType>, x);
+
+    if constexpr (detail::usesLibraryMath<FloatType>)
+        return std::exp2(x);
+    else
+        return detail::exp2Kernel(x);
+}
+
+template <typename FloatType>
+inline FloatType gainToDecibels(FloatType gain, FloatType minusInfinityDb = FloatType(-100))
+{
+    return gain > FloatType(0) ? juce::jmax(minusInfinityDb, decibelsPerLog2<FloatType> * log2(gain)) : minusInfinityDb;
+}
+
+template <typename FloatType>
+inline FloatType decibelsToGain(FloatType decibels)
+{
+    return exp2(decibels * (FloatType(1) / decibelsPerLog2<FloatType>));
+}
+
+/** Clamped on the register, then the kernel lane by lane: a fixed trip count of
+    straight-line code, which the compiler vectorises. */
+template <typename FloatType>
+inline juce::dsp::SIMDRegister<FloatType> log2(juce::dsp::SIMDRegister<FloatType> x)
+{
+    using Vec = juce::dsp::SIMDRegister<FloatType>;
+
+    alignas(Vec::SIMDRegisterSize) FloatType values[Vec::SIMDNumElements];
+    Vec::max(x, Vec::expand(std::numeric_limits<FloatType>::min())).copyToRawArray(values);
+
+    for (auto& v : values)
+    {
+        if constexpr (detail::usesLibraryMath<FloatType>)
+            v = std::log2(v);
+        else
+            v = detail::log2Kernel(v);
+    }
+
+    return Vec::fromRawArray(values);
+}
+
+template <typename FloatType>
+inline juce::dsp::SIMDRegister<FloatType> exp2(juce::dsp::SIMDRegister<FloatType> x)
+{
+    using Vec = juce::dsp::SIMDRegister<FloatType>;
+    constexpr auto limit = detail::exp2Limit<FloatType>;
+
+    alignas(Vec::SIMDRegisterSize) FloatType values[Vec::SIMDNumElements];
+    Vec::min(Vec::max(x, Vec::expand(-limit)), Vec::expand(limit)).copyToRawArray(values);
+
+    for (auto& v : values)
+    {
+        if constexpr (detail::usesLibraryMath<FloatType>)
+            v = std::exp2(v);
+        else
+            v = detail::exp2Kernel(v);
+    }
+
+    return Vec::fromRawArray(values);
+}
+}
@@ -0,0 +1,445 @@
+/*
+  ==============================================================================
+
+    LinearPhaseCrossover.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeGuard.h"
+
+/*
+    One background thread that rebuilds the kernels of every linear phase crossover in
+    the process, shared through juce::SharedResourcePointer like AnalyzerThread, so a
+    session full of instances polls from one thread rather than one per instance.
+
+    It polls rather than being notified, since signalling a thread takes a lock on the
+    audio thread.
+*/
+class CrossoverKernelBuilder : private juce::Thread
+{
+public:
+    /** Something with kernels to rebuild; called on the builder thread. */
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual void rebuildKernelsIfNeeded() = 0;
+    };
+
+    CrossoverKernelBuilder() : juce::Thread("Crossover kernel builder")
+    {
+        startThread();
+    }
+
+    ~CrossoverKernelBuilder() override
+    {
+        stopThread(1000);
+    }
+
+    void addClient(Client* client)
+    {
+        const RealtimeGuard::ScopedLock sl(clientLock);
+        clients.addIfNotAlreadyThere(client);
+    }
+
+    /** Waits for a rebuild in progress, so the client can be changed or deleted right after. */
+    void removeClient(Client* client)
+    {
+        const RealtimeGuard::ScopedLock sl(clientLock);
+        clients.removeFirstMatchingValue(client);
+    }
+
+private:
+    static constexpr int pollIntervalMs = 10;
+
+    RealtimeGuard::CheckedCriticalSection clientLock;
+    juce::Array<Client*> clients;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            {
+                const RealtimeGuard::ScopedLock sl(clientLock);
+
+                for (auto* client : clients)
+                    client->rebuildKernelsIfNeeded();
+            }
+
+            wait(pollIntervalMs);
+        }
+    }
+};
+
+/*
+    Phase-transparent band splitter: every band is a windowed-sinc FIR, run with
+    uniformly partitioned overlap-save convolution.
+
+        band 0     = LP(fc0)
+        band b     = LP(fc b) - LP(fc b-1)
+        last band  = delay - LP(fc last)
+
+    The band kernels telescope, so the bands always sum to the input delayed by
+    getLatencySamples(). Each channel's input is transformed once per partition and
+    shared by all bands; only the multiply-accumulate and inverse FFT are per band.
+
+    Kernels are rebuilt on the shared CrossoverKernelBuilder thread. The three kernel
+    slots are handed between the threads as a lock-free triple buffer, and the audio
+    thread crossfades from the old to the new kernels over one partition.
+
+    Spectra and kernels are stored split, all real parts followed by all imaginary parts,
+    each padded to whole SIMD registers, so the multiply-accumulate runs on SIMDRegister
+    like CrossoverEngine and CompressorEngine do.
+
+    juce::dsp::FFT is single precision, so the convolution always runs in float; double
+    buffers are converted on their way in and out.
+*/
+template <size_t NumBands>
+class LinearPhaseCrossover : private CrossoverKernelBuilder::Client
+{
+public:
+    static constexpr size_t numBands = NumBands;
+    static constexpr size_t numCrossovers = numBands - 1;
+    static constexpr int partitionSize = 256;
+
+    template <typename SampleType>
+    using BandBuffersOf = std::array<juce::AudioBuffer<SampleType>, numBands>;
+    using BandBuffers = BandBuffersOf<float>;
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    LinearPhaseCrossover()
+    {
+        for (size_t j = 0; j < numCrossovers; ++j)
+            requestedCutoffs[j].store(20.f * std::pow(1000.f, (j + 1.f) / numBands));
+    }
+
+    ~LinearPhaseCrossover() override
+    {
+        builder->removeClient(this);
+    }
+
+    /** Allocates everything and builds the first kernels; not for the audio thread. */
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        builder->removeClient(this);
+
+        sampleRate = spec.sampleRate;
+
+        //at least 85 ms of kernel keeps the transition bands narrow even for the lowest crossovers;
+        //the power of two makes it 4095 taps at 44.1 and 48 kHz, 93 and 85 ms
+        kernelLength = juce::nextPowerOfTwo(juce::roundToInt(sampleRate * 0.085)) - 1;
+        numPartitions = (kernelLength + partitionSize - 1) / partitionSize;
+
+        auto numChannels = static_cast<int>(spec.numChannels);
+
+        inputFifo.setSize(numChannels, partitionSize);
+        inputFrames.setSize(numChannels, fftSize);
+        for (auto& fifo : outputFifos)
+            fifo.setSize(numChannels, partitionSize);
+
+        spectra = allocateAligned(spectraStorage, static_cast<size_t>(numChannels * numPartitions) * spectrumSize);
+        accumulator = allocateAligned(accumulatorStorage, spectrumSize);
+
+        //one block for the three slots; each slot is whole registers long, so all stay aligned
+        auto kernelSize = numBands * static_cast<size_t>(numPartitions) * spectrumSize;
+        kernels[0] = allocateAligned(kernelStorage, kernels.size() * kernelSize);
+        for (size_t i = 1; i < kernels.size(); ++i)
+            kernels[i] = kernels[i - 1] + kernelSize;
+
+        fftBuffer.assign(2 * fftSize, 0.f);
+        builderBuffer.assign(2 * fftSize, 0.f);
+
+        fadeIn.resize(partitionSize);
+        for (auto i = 0; i < partitionSize; ++i)
+            fadeIn[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi * (i + 0.5f) / partitionSize);
+
+        builtGeneration = requestedGeneration.load(std::memory_order_acquire);
+        buildKernels(kernels[0]);
+
+        front = 0;
+        middle.store(1);
+        back = 2;
+
+        reset();
+        builder->addClient(this);
+    }
+
+    void reset()
+    {
+        inputFifo.clear();
+        inputFrames.clear();
+        for (auto& fifo : outputFifos)
+            fifo.clear();
+
+        std::fill(spectra, spectra + static_cast<size_t>(inputFifo.getNumChannels() * numPartitions) * spectrumSize, 0.f);
+        fifoPosition = 0;
+        partitionIndex = 0;
+    }
+
+    /** Input buffering plus the group delay of the kernels. */
+    int getLatencySamples() const { return partitionSize + (kernelLength - 1) / 2; }
+
+    /** Safe to call from the audio thread; the new kernels arrive a few blocks later. */
+    void setCrossoverFrequency(size_t index, float frequency)
+    {
+        jassert(index < numCrossovers);
+
+        if (requestedCutoffs[index].load(std::memory_order_relaxed) != frequency)
+        {
+            requestedCutoffs[index].store(frequency, std::memory_order_relaxed);
+            requestedGeneration.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    template <typename SampleType>
+    void process(const juce::AudioBuffer<SampleType>& input, BandBuffersOf<SampleType>& bands)
+    {
+        auto numChannels = input.getNumChannels();
+        auto numSamples = input.getNumSamples();
+        jassert(numChannels <= inputFifo.getNumChannels());
+
+        for (auto start = 0; start < numSamples;)
+        {
+            auto n = juce::jmin(numSamples - start, partitionSize - fifoPosition);
+
+            for (auto ch = 0; ch < numChannels; ++ch)
+            {
+                auto* in = input.getReadPointer(ch, start);
+                std::copy(in, in + n, inputFifo.getWritePointer(ch, fifoPosition));
+
+                for (size_t b = 0; b < numBands; ++b)
+                {
+                    auto* out = outputFifos[b].getReadPointer(ch, fifoPosition);
+                    std::copy(out, out + n, bands[b].getWritePointer(ch, start));
+                }
+            }
+
+            start += n;
+            fifoPosition += n;
+
+            if (fifoPosition == partitionSize)
+            {
+                processPartition(numChannels);
+                fifoPosition = 0;
+            }
+        }
+    }
+
+private:
+    static constexpr int fftOrder = 9;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr size_t vecSize = Vec::SIMDNumElements;
+    static constexpr size_t numBins = fftSize / 2 + 1;
+    static constexpr size_t planeSize = (numBins + vecSize - 1) / vecSize * vecSize;
+    static constexpr size_t spectrumSize = 2 * planeSize;           // split re, then im
+    static constexpr int dirtyBit = 4;
+
+    static_assert(fftSize == 2 * partitionSize, "overlap-save needs two partitions per frame");
+
+    double sampleRate = 44100.0;
+    int kernelLength = 0;
+    int numPartitions = 0;
+
+    //audio thread
+    juce::dsp::FFT fft { fftOrder };
+    juce::AudioBuffer<float> inputFifo, inputFrames;
+    BandBuffers outputFifos;
+    juce::HeapBlock<char> spectraStorage, accumulatorStorage;
+    float* spectra = nullptr;
+    float* accumulator = nullptr;
+    std::vector<float> fftBuffer, fadeIn;
+    int fifoPosition = 0;
+    int partitionIndex = 0;
+    int front = 0;
+
+    //shared
+    juce::HeapBlock<char> kernelStorage;
+    std::array<float*, 3> kernels {};
+    std::atomic<int> middle { 1 };
+    std::array<std::atomic<float>, numCrossovers> requestedCutoffs;
+    std::atomic<juce::uint32> requestedGeneration { 0 };
+
+    //builder thread
+    juce::SharedResourcePointer<CrossoverKernelBuilder> builder;
+    juce::dsp::FFT builderFft { fftOrder };
+    std::vector<float> builderBuffer;
+    int back = 2;
+    juce::uint32 builtGeneration = 0;
+
+    static float* allocateAligned(juce::HeapBlock<char>& storage, size_t size)
+    {
+        storage.allocate(size * sizeof(float) + Vec::SIMDRegisterSize, true);
+        return juce::snapPointerToAlignment(reinterpret_cast<float*>(storage.getData()), Vec::SIMDRegisterSize);
+    }
+
+    float* getSpectrum(int channel, int partition)
+    {
+        return spectra + static_cast<size_t>(channel * numPartitions + partition) * spectrumSize;
+    }
+
+    /** The FFT's interleaved re/im bins into the split layout; the padding stays zero. */
+    static void splitSpectrum(const float* interleaved, float* split)
+    {
+        for (size_t n = 0; n < numBins; ++n)
+        {
+            split[n]             = interleaved[2 * n];
+            split[planeSize + n] = interleaved[2 * n + 1];
+        }
+    }
+
+    static void interleaveSpectrum(const float* split, float* interleaved)
+    {
+        for (size_t n = 0; n < numBins; ++n)
+        {
+            interleaved[2 * n]     = split[n];
+            interleaved[2 * n + 1] = split[planeSize + n];
+        }
+    }
+
+    void processPartition(int numChannels)
+    {
+        for (auto ch = 0; ch < numChannels; ++ch)
+        {
+            auto* frame = inputFrames.getWritePointer(ch);
+            std::copy(frame + partitionSize, frame + fftSize, frame);
+            std::copy(inputFifo.getReadPointer(ch), inputFifo.getReadPointer(ch) + partitionSize, frame + partitionSize);
+
+            std::copy(frame, frame + fftSize, fftBuffer.begin());
+            std::fill(fftBuffer.begin() + fftSize, fftBuffer.end(), 0.f);
+            fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+            splitSpectrum(fftBuffer.data(), getSpectrum(ch, partitionIndex));
+        }
+
+        //the old slot is only given back after its last use, so the builder can't touch it mid-block
+        auto hasNewKernels = (middle.load(std::memory_order_acquire) & dirtyBit) != 0;
+
+        convolve(kernels[static_cast<size_t>(front)], numChannels, nullptr);
+
+        if (hasNewKernels)
+        {
+            front = middle.exchange(front, std::memory_order_acq_rel) & ~dirtyBit;
+            convolve(kernels[static_cast<size_t>(front)], numChannels, fadeIn.data());
+        }
+
+        partitionIndex = (partitionIndex + 1) % numPartitions;
+    }
+
+    /** Writes one partition of output per band, or crossfades into it when fade is given. */
+    void convolve(const float* kernel, int numChannels, const float* fade)
+    {
+        for (size_t b = 0; b < numBands; ++b)
+        {
+            for (auto ch = 0; ch < numChannels; ++ch)
+            {
+                std::fill(accumulator, accumulator + spectrumSize, 0.f);
+
+                for (auto p = 0; p < numPartitions; ++p)
+                {
+                    const auto* x = getSpectrum(ch, (partitionIndex + numPartitions - p) % numPartitions);
+                    const auto* h = kernel + (b * static_cast<size_t>(numPartitions) + static_cast<size_t>(p)) * spectrumSize;
+
+                    for (size_t k = 0; k < planeSize; k += vecSize)
+                    {
+                        auto xRe = Vec::fromRawArray(x + k), xIm = Vec::fromRawArray(x + planeSize + k);
+                        auto hRe = Vec::fromRawArray(h + k), hIm = Vec::fromRawArray(h + planeSize + k);
+
+                        auto* accRe = accumulator + k;
+                        auto* accIm = accumulator + planeSize + k;
+
+                        (Vec::fromRawArray(accRe) + xRe * hRe - xIm * hIm).copyToRawArray(accRe);
+                        (Vec::fromRawArray(accIm) + xRe * hIm + xIm * hRe).copyToRawArray(accIm);
+                    }
+                }
+
+                interleaveSpectrum(accumulator, fftBuffer.data());
+                fft.performRealOnlyInverseTransform(fftBuffer.data());
+
+                //overlap-save: only the second half of the frame is free of wrap-around
+                const auto* y = fftBuffer.data() + partitionSize;
+                auto* out = outputFifos[b].getWritePointer(ch);
+
+                if (fade == nullptr)
+                {
+                    std::copy(y, y + partitionSize, out);
+                }
+                else
+                {
+                    for (auto i = 0; i < partitionSize; ++i)
+                        out[i] += fade[i] * (y[i] - out[i]);
+                }
+            }
+        }
+    }
+
+    void rebuildKernelsIfNeeded() override
+    {
+        auto generation = requestedGeneration.load(std::memory_order_acquire);
+
+        if (generation == builtGeneration)
+            return;
+
+        builtGeneration = generation;
+        buildKernels(kernels[static_cast<size_t>(back)]);
+        back = middle.exchange(back | dirtyBit, std::memory_order_acq_rel) & ~dirtyBit;
+    }
+
+    void buildKernels(float* destination)
+    {
+        auto length = static_cast<size_t>(kernelLength);
+        auto centre = (kernelLength - 1) / 2;
+
+        std::vector<float> window(length), lowpass(length), previous(length, 0.f), band(length);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), length, juce::dsp::WindowingFunction<float>::blackman, false);
+
+        for (size_t b = 0; b < numBands; ++b)
+        {
+            if (b < numCrossovers)
+            {
+                auto fc = static_cast<double>(requestedCutoffs[b].load(std::memory_order_relaxed)) / sampleRate;
+                auto sum = 0.0;
+
+                for (auto n = 0; n < kernelLength; ++n)
+                {
+                    auto t = static_cast<double>(n - centre);
+                    auto sinc = t == 0.0 ? 2.0 * fc : std::sin(juce::MathConstants<double>::twoPi * fc * t) / (juce::MathConstants<double>::pi * t);
+                    lowpass[static_cast<size_t>(n)] = static_cast<float>(sinc * window[static_cast<size_t>(n)]);
+                    sum += lowpass[static_cast<size_t>(n)];
+                }
+
+                //unity gain at DC
+                for (auto& v : lowpass)
+                    v = static_cast<float>(v / sum);
+            }
+            else
+            {
+                std::fill(lowpass.begin(), lowpass.end(), 0.f);
+                lowpass[static_cast<size_t>(centre)] = 1.f;
+            }
+
+            for (size_t n = 0; n < length; ++n)
+                band[n] = lowpass[n] - previous[n];
+
+            std::swap(previous, lowpass);
+
+            for (auto p = 0; p < numPartitions; ++p)
+            {
+                auto start = p * partitionSize;
+                auto count = juce::jmin(partitionSize, kernelLength - start);
+
+                std::fill(builderBuffer.begin(), builderBuffer.end(), 0.f);
+                std::copy(band.begin() + start, band.begin() + start + count, builderBuffer.begin());
+                builderFft.performRealOnlyForwardTransform(builderBuffer.data(), true);
+
+                splitSpectrum(builderBuffer.data(), destination + (b * static_cast<size_t>(numPartitions) + static_cast<size_t>(p)) * spectrumSize);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(LinearPhaseCrossover)
+};
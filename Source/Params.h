@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+    Params.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef SIMPLEMBCOMP_NUM_BANDS
+ #define SIMPLEMBCOMP_NUM_BANDS 3
+#endif
+
+/*
+    Every parameter is addressed by a flat index that is generated from the band count:
+
+        crossover frequencies | per-band parameters, one run of NumBands per kind | globals
+
+    For three bands this is the order of the old hand-written Names enum, and the IDs
+    ("Threshold Low Band", "Low-Mid Crossover Freq", ...) are unchanged. The type, range
+    and default of each index come from getDescriptors().
+*/
+namespace Params
+{
+constexpr size_t NumBands = SIMPLEMBCOMP_NUM_BANDS;
+constexpr size_t NumCrossovers = NumBands - 1;
+
+static_assert(NumBands >= 2 && NumBands <= 8, "the crossover supports 2 to 8 bands");
+
+enum class BandParam
+{
+    Threshold,
+    Attack,
+    Release,
+    Ratio,
+    Knee,
+    Bypassed,
+    Mute,
+    Solo,
+    Sidechain,
+
+    NumBandParams
+};
+
+constexpr size_t NumBandParams = static_cast<size_t>(BandParam::NumBandParams);
+
+constexpr size_t crossoverFreq(size_t crossover) { return crossover; }
+constexpr size_t bandParam(BandParam param, size_t band) { return NumCrossovers + static_cast<size_t>(param) * NumBands + band; }
+
+constexpr size_t GainIn = NumCrossovers + NumBandParams * NumBands;
+constexpr size_t GainOut = GainIn + 1;
+constexpr size_t Lookahead = GainOut + 1;
+constexpr size_t CrossoverMode = Lookahead + 1;
+constexpr size_t ChannelLink = CrossoverMode + 1;
+constexpr size_t Detector = ChannelLink + 1;
+constexpr size_t Morph = Detector + 1;
+constexpr size_t CrossoverSlope = Morph + 1;
+constexpr size_t NumParams = CrossoverSlope + 1;
+
+/** Upper end of the Lookahead parameter; the delay lines are sized for it. */
+constexpr float MaxLookaheadMs = 20.f;
+
+inline juce::String getBandName(size_t band)
+{
+    if (NumBands == 2)
+        return band == 0 ? "Low" : "High";
+
+    if (NumBands == 3)
+        return juce::StringArray { "Low", "Mid", "High" }[static_cast<int>(band)];
+
+    return juce::String(static_cast<int>(band) + 1);
+}
+
+inline const char* getBandParamName(BandParam param)
+{
+    const char* names[] = { "Threshold", "Attack", "Release", "Ratio", "Knee", "Bypassed", "Mute", "Solo", "Sidechain" };
+    static_assert(sizeof(names) / sizeof(names[0]) == NumBandParams, "one name per band parameter");
+
+    return names[static_cast<size_t>(param)];
+}
+
+/** The parameter ID, which is also its display name. */
+inline const juce::String& getName(size_t index)
+{
+    static const auto names = []
+    {
+        std::array<juce::String, NumParams> n;
+
+        for (size_t j = 0; j < NumCrossovers; ++j)
+        {
+            n[crossoverFreq(j)] = NumBands <= 3 ? getBandName(j) + "-" + getBandName(j + 1) + " Crossover Freq"
+                                                : "Crossover " + getBandName(j) + "-" + getBandName(j + 1) + " Freq";
+        }
+
+        for (size_t k = 0; k < NumBandParams; ++k)
+        {
+            auto kind = juce::String(getBandParamName(static_cast<BandParam>(k)));
+
+            for (size_t b = 0; b < NumBands; ++b)
+            {
+                n[bandParam(static_cast<BandParam>(k), b)] = NumBands <= 3 ? kind + " " + getBandName(b) + " Band"
+                                                                           : kind + " Band " + getBandName(b);
+            }
+        }
+
+        n[GainIn] = "Gain In";
+        n[GainOut] = "Gain Out";
+        n[Lookahead] = "Lookahead";
+        n[CrossoverMode] = "Crossover Mode";
+        n[ChannelLink] = "Channel Link";
+        n[Detector] = "Detector";
+        n[Morph] = "Morph";
+        n[CrossoverSlope] = "Crossover Slope";
+
+        return n;
+    }();
+
+    return names[index];
+}
+
+/** A 32-bit FNV-1a hash of the parameter ID, which saved states and preset banks store
+    in place of the ID itself. */
+inline juce::uint32 getIdHash(size_t index)
+{
+    static const auto hashes = []
+    {
+        std::array<juce::uint32, NumParams> h;
+
+        for (size_t i = 0; i < NumParams; ++i)
+        {
+            juce::uint32 hash = 2166136261u;
+
+            for (auto* c = getName(i).toRawUTF8(); *c != 0; ++c)
+                hash = (hash ^ static_cast<juce::uint8>(*c)) * 16777619u;
+
+            h[i] = hash;
+        }
+
+        for (size_t i = 0; i < NumParams; ++i)
+            for (size_t j = i + 1; j < NumParams; ++j)
+                jassert(h[i] != h[j]);
+
+        return h;
+    }();
+
+    return hashes[index];
+}
+
+/** The index whose ID has the given hash, or NumParams if there is none. The search
+    starts at hint, so reading values stored in index order finds each one straight away. */
+inline size_t findIndex(juce::uint32 idHash, size_t hint = 0)
+{
+    for (size_t k = 0; k < NumParams; ++k)
+    {
+        auto index = (hint + k) % NumParams;
+        if (getIdHash(index) == idHash)
+            return index;
+    }
+
+    return NumParams;
+}
+
+/** Crossover ranges don't overlap, so the band order can never flip. */
+inline juce::NormalisableRange<float> getCrossoverRange(size_t crossover)
+{
+    if (NumBands == 3)
+        return crossover == 0 ? juce::NormalisableRange<float>(20, 999, 1, 1)
+                              : juce::NormalisableRange<float>(1000, 20000, 1, 1);
+
+    //split 20 Hz - 20 kHz into equal octave spans, one per crossover
+    auto edge = [](size_t k) { return std::round(20.f * std::pow(1000.f, static_cast<float>(k) / NumCrossovers)); };
+    auto range = juce::NormalisableRange<float>(edge(crossover), edge(crossover + 1) - (crossover + 1 < NumCrossovers ? 1.f : 0.f), 1, 1);
+    range.setSkewForCentre(std::sqrt(range.start * range.end));
+
+    return range;
+}
+
+inline float getCrossoverDefault(size_t crossover)
+{
+    if (NumBands == 3)
+        return crossover == 0 ? 400.f : 2000.f;
+
+    auto range = getCrossoverRange(crossover);
+    return std::round(std::sqrt(range.start * range.end));
+}
+
+/** Choices of the Crossover Mode parameter, in index order. */
+inline const juce::StringArray& getCrossoverModeChoices()
+{
+    static const juce::StringArray choices { "Linkwitz-Riley", "Linear Phase" };
+    return choices;
+}
+
+/** Choices of the Crossover Slope parameter, the Linkwitz-Riley orders of the IIR crossover. */
+inline const juce::StringArray& getCrossoverSlopeChoices()
+{
+    static const juce::StringArray choices { "12 dB/oct", "24 dB/oct", "48 dB/oct" };
+    return choices;
+}
+
+/** Choices of the Channel Link parameter: a detector per channel, one per channel group,
+    or one each for the mid and side of a stereo pair. */
+inline const juce::StringArray& getChannelLinkChoices()
+{
+    static const juce::StringArray choices { "Unlinked", "Linked", "Mid/Side" };
+    return choices;
+}
+
+/** Choices of the Detector parameter, what the compressor envelopes follow. */
+inline const juce::StringArray& getDetectorChoices()
+{
+    static const juce::StringArray choices { "Peak", "RMS" };
+    return choices;
+}
+
+inline constexpr std::array<float, 14> RatioChoices { 1.f, 1.5f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 10.f, 15.f, 20.f, 50.f, 100.f };
+
+/** RatioChoices as the Ratio parameters show them. */
+inline const juce::StringArray& getRatioChoices()
+{
+    static const auto choices = []
+    {
+        juce::StringArray sa;
+        for (auto choice : RatioChoices)
+            sa.add(juce::String(choice, 1));
+
+        return sa;
+    }();
+
+    return choices;
+}
+
+enum class Kind
+{
+    Float,
+    Choice,
+    Bool
+};
+
+/** Everything needed to create a parameter, apart from its name. */
+struct Descriptor
+{
+    Kind kind = Kind::Bool;
+    juce::NormalisableRange<float> range {};                // Float only
+    float defaultValue = 0;                                 // the index for a Choice, 0 or 1 for a Bool
+    const juce::StringArray& (*getChoices)() = nullptr;     // Choice only
+};
+
+/** One descriptor per parameter index, built once per process and shared by every instance. */
+inline const std::array<Descriptor, NumParams>& getDescriptors()
+{
+    static const auto descriptors = []
+    {
+        std::array<Descriptor, NumParams> d;
+
+        auto gainRange = juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1);
+        auto attackReleaseRange = juce::NormalisableRange<float>(5, 500, 1, 1);
+
+        for (size_t j = 0; j < NumCrossovers; ++j)
+            d[crossoverFreq(j)] = { Kind::Float, getCrossoverRange(j), getCrossoverDefault(j) };
+
+        for (size_t b = 0; b < NumBands; ++b)
+        {
+            d[bandParam(BandParam::Threshold, b)] = { Kind::Float, juce::NormalisableRange<float>(-60, 12, 1, 1), 0 };
+            d[bandParam(BandParam::Attack, b)] = { Kind::Float, attackReleaseRange, 50 };
+            d[bandParam(BandParam::Release, b)] = { Kind::Float, attackReleaseRange, 250 };
+            d[bandParam(BandParam::Ratio, b)] = { Kind::Choice, {}, 3, getRatioChoices };
+
+            //0 dB is the hard knee the compressor always had
+            d[bandParam(BandParam::Knee, b)] = { Kind::Float, juce::NormalisableRange<float>(0, 24, 0.5f, 1), 0 };
+
+            for (auto param : { BandParam::Bypassed, BandParam::Mute, BandParam::Solo, BandParam::Sidechain })
+                d[bandParam(param, b)] = { Kind::Bool };
+        }
+
+        d[GainIn] = { Kind::Float, gainRange, 0 };
+        d[GainOut] = { Kind::Float, gainRange, 0 };
+        d[Lookahead] = { Kind::Float, juce::NormalisableRange<float>(0, MaxLookaheadMs, 0.1f, 1), 0 };
+        d[CrossoverMode] = { Kind::Choice, {}, 0, getCrossoverModeChoices };
+        d[ChannelLink] = { Kind::Choice, {}, 0, getChannelLinkChoices };
+        d[Detector] = { Kind::Choice, {}, 0, getDetectorChoices };
+
+        //0 plays snapshot A, 1 snapshot B, see PresetMorph
+        d[Morph] = { Kind::Float, juce::NormalisableRange<float>(0, 1), 0 };
+
+        //24 dB/oct is the slope the crossover always had
+        d[CrossoverSlope] = { Kind::Choice, {}, 1, getCrossoverSlopeChoices };
+
+        return d;
+    }();
+
+    return descriptors;
+}
+}
@@ -9,13 +9,170 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+ParameterControl::ParameterControl(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, const juce::String& labelText)
+{
+    auto* param = apvts.getParameter(paramID);
+    jassert(param != nullptr);
+    
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(param))
+    {
+        //items have to exist before the attachment selects one
+        comboBox.addItemList(choice->choices, 1);
+        comboBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(apvts, paramID, comboBox);
+        addAndMakeVisible(comboBox);
+    }
+    else if (dynamic_cast<juce::AudioParameterBool*>(param) != nullptr)
+    {
+        button.setButtonText(labelText);
+        buttonAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, paramID, button);
+        addAndMakeVisible(button);
+        return;
+    }
+    else
+    {
+        slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+        slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 64, 16);
+        sliderAttachment = std::make_unique<APVTS::SliderAttachment>(apvts, paramID, slider);
+        addAndMakeVisible(slider);
+    }
+    
+    label.setText(labelText, juce::dontSendNotification);
+    label.setJustificationType(juce::Justification::centred);
+    label.setFont(12.f);
+    addAndMakeVisible(label);
+}
+
+void ParameterControl::resized()
+{
+    auto bounds = getLocalBounds();
+    
+    if (button.isVisible())
+    {
+        button.setBounds(bounds);
+        return;
+    }
+    
+    label.setBounds(bounds.removeFromTop(16));
+    
+    if (comboBox.isVisible())
+        comboBox.setBounds(bounds.withSizeKeepingCentre(bounds.getWidth(), juce::jmin(24, bounds.getHeight())));
+    else
+        slider.setBounds(bounds);
+}
+
+//==============================================================================
+void BandMeterDisplay::setLevels(const BandLevels& newLevels)
+{
+    levels = newLevels;
+    repaint();
+}
+
+void BandMeterDisplay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
+    auto rowHeight = bounds.getHeight() / 3;
+    
+    auto toWidth = [](float proportion, int width)
+    {
+        return juce::roundToInt(juce::jlimit(0.f, 1.f, proportion) * static_cast<float>(width));
+    };
+    
+    auto levelToProportion = [](float gain)
+    {
+        return juce::jmap(juce::Decibels::gainToDecibels(gain, minDb), minDb, 0.f, 0.f, 1.f);
+    };
+    
+    auto drawRow = [&](const juce::String& name, float proportion, float peakProportion, juce::Colour colour)
+    {
+        auto row = bounds.removeFromTop(rowHeight).reduced(0, 1);
+        
+        g.setColour (juce::Colours::white);
+        g.setFont (11.f);
+        g.drawText (name, row.removeFromLeft(28), juce::Justification::centredLeft);
+        
+        g.setColour (juce::Colours::black);
+        g.fillRect (row);
+        
+        g.setColour (colour);
+        g.fillRect (row.withWidth(toWidth(proportion, row.getWidth())));
+        
+        if (peakProportion > 0.f)
+            g.fillRect (row.getX() + toWidth(peakProportion, row.getWidth()) - 1, row.getY(), 2, row.getHeight());
+    };
+    
+    drawRow ("In", levelToProportion(levels.inputRms), levelToProportion(levels.inputPeak), juce::Colours::lightgreen);
+    drawRow ("Out", levelToProportion(levels.outputRms), levelToProportion(levels.outputPeak), juce::Colours::lightgreen);
+    drawRow ("GR", -levels.gainReductionDb / maxReductionDb, 0.f, juce::Colours::orange);
+}
+
 //==============================================================================
 SimpleMbCompAudioProcessorEditor::SimpleMbCompAudioProcessorEditor (SimpleMbCompAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), analyzer (p), meterReader (p.getMeterFifo())
 {
+    using namespace Params;
+    
+    auto& apvts = audioProcessor.apvts;
+    
+    addAndMakeVisible(analyzer);
+    
+    //global strip: gains, crossovers and the processing options
+    globalControls.add(new ParameterControl(apvts, getName(GainIn), getName(GainIn)));
+    
+    for (size_t j = 0; j < NumCrossovers; ++j)
+        globalControls.add(new ParameterControl(apvts, getName(crossoverFreq(j)), getBandName(j) + "-" + getBandName(j + 1)));
+    
+    globalControls.add(new ParameterControl(apvts, getName(GainOut), getName(GainOut)));
+    globalControls.add(new ParameterControl(apvts, getName(Lookahead), getName(Lookahead)));
+    globalControls.add(new ParameterControl(apvts, getName(CrossoverMode), getName(CrossoverMode)));
+    globalControls.add(new ParameterControl(apvts, getName(CrossoverSlope), getName(CrossoverSlope)));
+    globalControls.add(new ParameterControl(apvts, getName(ChannelLink), getName(ChannelLink)));
+    globalControls.add(new ParameterControl(apvts, getName(Detector), getName(Detector)));
+    globalControls.add(new ParameterControl(apvts, getName(Morph), getName(Morph)));
+    
+    storeAButton.onClick = [this] { audioProcessor.storeMorphSnapshot(PresetMorph::slotA); };
+    storeBButton.onClick = [this] { audioProcessor.storeMorphSnapshot(PresetMorph::slotB); };
+    clearMorphButton.onClick = [this] { audioProcessor.clearMorphSnapshots(); };
+    
+    for (auto* button : { &storeAButton, &storeBButton, &clearMorphButton })
+        addAndMakeVisible(button);
+    
+    for (size_t band = 0; band < NumBands; ++band)
+    {
+        for (size_t k = 0; k < NumBandParams; ++k)
+        {
+            auto kind = static_cast<BandParam>(k);
+            bandControls[band].add(new ParameterControl(apvts, getName(bandParam(kind, band)), getBandParamName(kind)));
+        }
+    }
+    
+    for (auto* control : globalControls)
+        addAndMakeVisible(control);
+    
+    for (auto& controls : bandControls)
+        for (auto* control : controls)
+            addAndMakeVisible(control);
+    
+    for (auto& meter : bandMeters)
+        addAndMakeVisible(meter);
+    
+    meterReader.onUpdate = [this]
+    {
+        const auto& frame = meterReader.getLevels();
+        
+        for (size_t band = 0; band < Params::NumBands; ++band)
+            bandMeters[band].setLevels(frame.bands[band]);
+    };
+    
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    auto numRows = static_cast<int>((NumBands + bandsPerRow - 1) / bandsPerRow);
+    auto bandsWidth = static_cast<int>(juce::jmin(NumBands, static_cast<size_t>(bandsPerRow))) * bandWidth;
+    auto globalsWidth = 20 + morphButtonWidth;
+    for (auto* control : globalControls)
+        globalsWidth += getGlobalControlWidth(*control);
+    
+    setSize (juce::jmax(bandsWidth, globalsWidth) + 20, analyzerHeight + globalHeight + numRows * bandHeight + 20);
 }
 
 SimpleMbCompAudioProcessorEditor::~SimpleMbCompAudioProcessorEditor()
@@ -29,11 +186,80 @@ void SimpleMbCompAudioProcessorEditor::paint (juce::Graphics& g)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
     g.setColour (juce::Colours::white);
+    g.setFont (14.f);
     
+    for (size_t band = 0; band < Params::NumBands; ++band)
+    {
+        auto area = getBandArea(band);
+        g.setColour (juce::Colours::dimgrey);
+        g.drawRoundedRectangle (area.toFloat().reduced(4.f), 4.f, 1.f);
+        
+        g.setColour (juce::Colours::white);
+        g.drawText (Params::NumBands <= 3 ? Params::getBandName(band) + " Band" : "Band " + Params::getBandName(band),
+                    area.reduced(8, 6).removeFromTop(18), juce::Justification::centredLeft);
+    }
+}
+
+juce::Rectangle<int> SimpleMbCompAudioProcessorEditor::getBandArea(size_t band) const
+{
+    auto row = static_cast<int>(band) / bandsPerRow;
+    auto column = static_cast<int>(band) % bandsPerRow;
+    
+    return { 10 + column * bandWidth, analyzerHeight + globalHeight + 10 + row * bandHeight, bandWidth, bandHeight };
+}
+
+int SimpleMbCompAudioProcessorEditor::getGlobalControlWidth(const ParameterControl& control)
+{
+    return control.isComboBox() ? 120 : 80;
 }
 
 void SimpleMbCompAudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
+    auto bounds = getLocalBounds().reduced(10, 0);
+    
+    analyzer.setBounds(bounds.removeFromTop(analyzerHeight).withTrimmedTop(10));
+    
+    auto globals = bounds.removeFromTop(globalHeight).reduced(0, 6);
+    for (auto* control : globalControls)
+        control->setBounds(globals.removeFromLeft(getGlobalControlWidth(*control)).reduced(2));
+    
+    //stacked next to the Morph knob
+    auto morphButtons = globals.removeFromLeft(morphButtonWidth).reduced(2);
+    auto buttonHeight = morphButtons.getHeight() / 3;
+    storeAButton.setBounds(morphButtons.removeFromTop(buttonHeight).reduced(0, 2));
+    storeBButton.setBounds(morphButtons.removeFromTop(buttonHeight).reduced(0, 2));
+    clearMorphButton.setBounds(morphButtons.reduced(0, 2));
+    
+    using Params::BandParam;
+    
+    for (size_t band = 0; band < Params::NumBands; ++band)
+    {
+        auto area = getBandArea(band).reduced(10, 8);
+        area.removeFromTop(20);
+        
+        auto& controls = bandControls[band];
+        auto control = [&controls](BandParam kind) { return controls[static_cast<int>(kind)]; };
+        
+        auto knobs = area.removeFromTop(96);
+        auto knobWidth = knobs.getWidth() / 3;
+        control(BandParam::Threshold)->setBounds(knobs.removeFromLeft(knobWidth));
+        control(BandParam::Attack)->setBounds(knobs.removeFromLeft(knobWidth));
+        control(BandParam::Release)->setBounds(knobs);
+        
+        auto shape = area.removeFromTop(72);
+        control(BandParam::Ratio)->setBounds(shape.removeFromLeft(knobWidth * 2).withSizeKeepingCentre(knobWidth * 2, 40));
+        control(BandParam::Knee)->setBounds(shape);
+        
+        auto toggles = area.removeFromTop(24);
+        auto toggleWidth = toggles.getWidth() / 3;
+        control(BandParam::Bypassed)->setBounds(toggles.removeFromLeft(toggleWidth));
+        control(BandParam::Mute)->setBounds(toggles.removeFromLeft(toggleWidth));
+        control(BandParam::Solo)->setBounds(toggles);
+        
+        control(BandParam::Sidechain)->setBounds(area.removeFromTop(24).removeFromLeft(toggleWidth * 2));
+        
+        bandMeters[band].setBounds(area.removeFromTop(meterHeight).withTrimmedTop(4));
+    }
 }
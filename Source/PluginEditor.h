@@ -10,6 +10,50 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+
+/** A labelled control for one parameter: rotary slider, combo box or toggle, by parameter type. */
+class ParameterControl  : public juce::Component
+{
+public:
+    ParameterControl(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, const juce::String& labelText);
+    
+    void resized() override;
+    
+    bool isComboBox() const { return comboBoxAttachment != nullptr; }
+    
+private:
+    using APVTS = juce::AudioProcessorValueTreeState;
+    
+    juce::Label label;
+    juce::Slider slider;
+    juce::ComboBox comboBox;
+    juce::ToggleButton button;
+    
+    std::unique_ptr<APVTS::SliderAttachment> sliderAttachment;
+    std::unique_ptr<APVTS::ComboBoxAttachment> comboBoxAttachment;
+    std::unique_ptr<APVTS::ButtonAttachment> buttonAttachment;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterControl)
+};
+
+/** Input, output and gain reduction bars for one band. The level bars show the RMS
+    with a line at the peak. */
+class BandMeterDisplay  : public juce::Component
+{
+public:
+    void setLevels(const BandLevels& newLevels);
+    
+    void paint(juce::Graphics& g) override;
+    
+private:
+    BandLevels levels;
+    
+    static constexpr float minDb = -60.f;
+    static constexpr float maxReductionDb = 24.f;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandMeterDisplay)
+};
 
 //==============================================================================
 /**
@@ -28,6 +72,29 @@ private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     SimpleMbCompAudioProcessor& audioProcessor;
+    
+    SpectrumAnalyzer analyzer;
+    
+    //the editor is the processor's only meter reader while it is open
+    MeterReader meterReader;
+    std::array<BandMeterDisplay, Params::NumBands> bandMeters;
+    
+    juce::OwnedArray<ParameterControl> globalControls;
+    std::array<juce::OwnedArray<ParameterControl>, Params::NumBands> bandControls;
+    
+    //store the current settings as a morph snapshot, or drop both
+    juce::TextButton storeAButton { "Store A" }, storeBButton { "Store B" }, clearMorphButton { "Clear A/B" };
+    static constexpr int morphButtonWidth = 72;
+    
+    static constexpr int bandsPerRow = 4;
+    static constexpr int bandWidth = 230;
+    static constexpr int bandHeight = 292;
+    static constexpr int meterHeight = 36;
+    static constexpr int globalHeight = 100;
+    static constexpr int analyzerHeight = 260;
+    
+    juce::Rectangle<int> getBandArea(size_t band) const;
+    static int getGlobalControlWidth(const ParameterControl& control);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleMbCompAudioProcessorEditor)
 };
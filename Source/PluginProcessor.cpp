@@ -18,6 +18,7 @@ SimpleMbCompAudioProcessor::SimpleMbCompAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
@@ -25,75 +26,72 @@ SimpleMbCompAudioProcessor::SimpleMbCompAudioProcessor()
 #endif
 {
     using namespace Params;
-    const auto& params = GetParams();
     
-    auto floatHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    //createParameterLayout kept a pointer to every parameter it made, and the descriptors
+    //say which type each one is, so nothing is looked up by ID or cast dynamically
+    auto floatHelper = [this](auto& param, size_t index)
     {
-        param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
-        
+        jassert(getDescriptors()[index].kind == Kind::Float);
+        param = static_cast<juce::AudioParameterFloat*>(parameters[index]);
     };
     
-    auto choiceHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
-        {
-            param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
-            jassert(param != nullptr);
-            
-        };
-    
-    auto boolHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
-       {
-           param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
-           jassert(param != nullptr);
-           
-       };
-    
-    floatHelper(lowBandComp.attack, Names::Attack_Low_Band);
-    floatHelper(lowBandComp.release, Names::Release_Low_Band);
-    floatHelper(lowBandComp.threshold, Names::Threshold_Low_band);
-    
-    floatHelper(midBandComp.attack, Names::Attack_Mid_Band);
-    floatHelper(midBandComp.release, Names::Release_Mid_Band);
-    floatHelper(midBandComp.threshold, Names::Threshold_Mid_band);
-    
-    floatHelper(highBandComp.attack, Names::Attack_High_Band);
-    floatHelper(highBandComp.release, Names::Release_High_Band);
-    floatHelper(highBandComp.threshold, Names::Threshold_High_band);
-
-    choiceHelper(lowBandComp.ratio, Names::Ratio_Low_Band);
-    choiceHelper(midBandComp.ratio, Names::Ratio_Mid_Band);
-    choiceHelper(highBandComp.ratio, Names::Ratio_High_Band);
-    
-    boolHelper(lowBandComp.bypassed, Names::Bypassed_Low_Band);
-    boolHelper(midBandComp.bypassed, Names::Bypassed_Mid_Band);
-    boolHelper(highBandComp.bypassed, Names::Bypassed_High_Band);
+    auto choiceHelper = [this](auto& param, size_t index)
+    {
+        jassert(getDescriptors()[index].kind == Kind::Choice);
+        param = static_cast<juce::AudioParameterChoice*>(parameters[index]);
+    };
     
-    boolHelper(lowBandComp.mute, Names::Mute_Low_Band);
-    boolHelper(midBandComp.mute, Names::Mute_Mid_Band);
-    boolHelper(highBandComp.mute, Names::Mute_High_Band);
+    auto boolHelper = [this](auto& param, size_t index)
+    {
+        jassert(getDescriptors()[index].kind == Kind::Bool);
+        param = static_cast<juce::AudioParameterBool*>(parameters[index]);
+    };
     
-    boolHelper(lowBandComp.solo, Names::Solo_Low_Band);
-    boolHelper(midBandComp.solo, Names::Solo_Mid_Band);
-    boolHelper(highBandComp.solo, Names::Solo_High_Band);
+    for (size_t band = 0; band < NumBands; ++band)
+    {
+        auto& comp = bandParams[band];
+        
+        floatHelper(comp.attack, bandParam(BandParam::Attack, band));
+        floatHelper(comp.release, bandParam(BandParam::Release, band));
+        floatHelper(comp.threshold, bandParam(BandParam::Threshold, band));
+        choiceHelper(comp.ratio, bandParam(BandParam::Ratio, band));
+        floatHelper(comp.knee, bandParam(BandParam::Knee, band));
+        boolHelper(comp.bypassed, bandParam(BandParam::Bypassed, band));
+        boolHelper(comp.mute, bandParam(BandParam::Mute, band));
+        boolHelper(comp.solo, bandParam(BandParam::Solo, band));
+        boolHelper(comp.sidechain, bandParam(BandParam::Sidechain, band));
+    }
     
-    LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    LP2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    for (size_t j = 0; j < NumCrossovers; ++j)
+        floatHelper(crossoverFreqs[j], crossoverFreq(j));
     
+    floatHelper(inputGainParam, GainIn);
+    floatHelper(outputGainParam, GainOut);
+    floatHelper(lookaheadParam, Lookahead);
+    choiceHelper(crossoverModeParam, CrossoverMode);
+    choiceHelper(crossoverSlopeParam, CrossoverSlope);
+    choiceHelper(channelLinkParam, ChannelLink);
+    choiceHelper(detectorParam, Detector);
+    floatHelper(morphParam, Morph);
     
-    AP2.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    //only exported where asked for, so benchmark runs don't leave files behind
+    auto profileDirectory = juce::SystemStats::getEnvironmentVariable("SIMPLEMBCOMP_PROFILE_DIR", {});
     
-    floatHelper(lowMidCrossover, Names::Low_Mid_Crossover_Freq);
-    floatHelper(midHighCrossover, Names::Mid_High_Crossover_Freq);
+    if (profileDirectory.isNotEmpty())
+    {
+        auto directory = juce::File::getCurrentWorkingDirectory().getChildFile(profileDirectory);
+        directory.createDirectory();
+        profiler.startExporting(directory.getNonexistentChildFile("SimpleMbComp-profile", ".csv"), profileExportIntervalMs);
+    }
+   #endif
     
-    floatHelper(inputGainParam, Names::Gain_In);
-    floatHelper(outputGainParam, Names::Gain_Out);
-   
+    startTimerHz(20);
 }
 
 SimpleMbCompAudioProcessor::~SimpleMbCompAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -131,26 +129,52 @@ bool SimpleMbCompAudioProcessor::isMidiEffect() const
 
 double SimpleMbCompAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    //the lookahead and linear phase delays keep playing out after the input stops, and
+    //the gain reduction goes on releasing after that. The longest release the parameters
+    //allow, rather than the current one, so automation and the morph never outrun it
+    auto sampleRate = getSampleRate();
+    auto delaySeconds = sampleRate > 0 ? getTotalLatencySamples(sampleRate) / sampleRate : lookaheadParam->get() / 1000.0;
+    auto releaseMs = Params::getDescriptors()[Params::bandParam(Params::BandParam::Release, 0)].range.end;
+    
+    return delaySeconds + releaseMs / 1000.0;
 }
 
 int SimpleMbCompAudioProcessor::getNumPrograms()
 {
+    if (presetBank != nullptr && presetBank->getNumPresets() > 0)
+        return presetBank->getNumPresets();
+    
     return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
                 // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int SimpleMbCompAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
 void SimpleMbCompAudioProcessor::setCurrentProgram (int index)
 {
+    if (index < 0)
+        return;
+    
+    //hosts may call this from any thread, the audio thread included
+    if (juce::MessageManager::existsAndIsCurrentThread())
+    {
+        loadProgram(index);
+    }
+    else
+    {
+        requestedProgram.store(index);
+        updatePending.store(true);
+    }
 }
 
 const juce::String SimpleMbCompAudioProcessor::getProgramName (int index)
 {
+    if (presetBank != nullptr && juce::isPositiveAndBelow(index, presetBank->getNumPresets()))
+        return presetBank->getName(index);
+    
     return {};
 }
 
@@ -161,40 +185,57 @@ void SimpleMbCompAudioProcessor::changeProgramName (int index, const juce::Strin
 //==============================================================================
 void SimpleMbCompAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    //everything is sized for one chunk, see setInternalBlockSize
+    internalBlockSize = juce::jmax(1, requestedInternalBlockSize > 0 ? requestedInternalBlockSize : samplesPerBlock);
+    
     juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
+    spec.maximumBlockSize = static_cast<juce::uint32>(internalBlockSize);
     spec.numChannels = getTotalNumOutputChannels();
     spec.sampleRate = sampleRate;
     
-    for (auto& comp : compressors)
-        comp.prepare(spec);
+    //the morph settles first, so everything below starts at the settings it will play
+    ParameterChangeTracker::Changes settled;
+    morph.update(morphParam->get(), settled);
     
+    //so the first kernels are built for the current settings rather than rebuilt right away
+    for (size_t j = 0; j < Params::NumCrossovers; ++j)
+        linearPhaseCrossover.setCrossoverFrequency(j, getCrossoverFrequency(j));
     
-    LP1.prepare(spec);
-    HP1.prepare(spec);
+    //the sidechain goes through the same crossovers, in the channels after the main ones
+    auto splitSpec = spec;
+    splitSpec.numChannels += static_cast<juce::uint32>(getChannelCountOfBus(true, 1));
+    jassert(splitSpec.numChannels <= static_cast<juce::uint32>(maxSplitChannels));
     
-    AP2.prepare(spec);
+    forEachChain([&](auto& chain) { prepareChain(chain, spec, splitSpec); });
+    linearPhaseCrossover.prepare(splitSpec);
     
-   
-    LP2.prepare(spec);
-    HP2.prepare(spec);
+    //mono and stereo sessions at ordinary block sizes never need the pool, so they don't start
+    //its threads, and a live session lets go of it again if the workers can't run at realtime priority
+    auto numSplitChannels = static_cast<int>(splitSpec.numChannels);
     
-    inputGain.prepare(spec);
-    outputGain.prepare(spec);
+    if (workerPool == nullptr && canRunInParallel(internalBlockSize, numSplitChannels))
+        workerPool = std::make_unique<juce::SharedResourcePointer<RealtimeWorkerPool>>();
     
-    inputGain.setRampDurationSeconds(0.05);
-    outputGain.setRampDurationSeconds(0.05);
+    if (shouldRunInParallel(internalBlockSize, numSplitChannels))
+        (*workerPool)->wakeUp();
+    else
+        workerPool.reset();
     
-    for (auto& buffer : filterBuffers)
-    {
-        buffer.setSize(spec.numChannels, samplesPerBlock);
-    }
+    setLatencySamples(getTotalLatencySamples(sampleRate));
+    
+    bandWasAudible.fill(false);
+    silentSamples = 0;
+    samplesProcessed = 0;
+    silenceHoldSamples = static_cast<juce::int64>(sampleRate * silenceHoldSeconds);
+    
+    parameterChanges.markAllChanged();
 }
 
 void SimpleMbCompAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    workerPool.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -204,18 +245,34 @@ bool SimpleMbCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // Mono, stereo and the common surround and immersive layouts.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    const auto& output = layouts.getMainOutputChannelSet();
+    
+    if (output != juce::AudioChannelSet::mono()
+     && output != juce::AudioChannelSet::stereo()
+     && output != juce::AudioChannelSet::create5point1()
+     && output != juce::AudioChannelSet::create7point1()
+     && output != juce::AudioChannelSet::create7point1point4())
         return false;
 
     // This checks if the input layout matches the output layout
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    // The sidechain can be off, mono, stereo or laid out like the main bus.
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto& key = layouts.getChannelSet(true, 1);
+        
+        if (! key.isDisabled()
+         && key != juce::AudioChannelSet::mono()
+         && key != juce::AudioChannelSet::stereo()
+         && key != output)
+            return false;
+    }
    #endif
 
     return true;
@@ -223,95 +280,351 @@ bool SimpleMbCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
 }
 #endif
 
-void SimpleMbCompAudioProcessor::updateState()
+namespace
 {
-    for (auto& compressor : compressors)
-      {
-          compressor.updateCompressorSettings();
-      }
-    
-    auto lowMidCutoffFreq = lowMidCrossover->get();
-       LP1.setCutoffFrequency(lowMidCutoffFreq);
-       HP1.setCutoffFrequency(lowMidCutoffFreq);
-       
-       
-       auto midHighCutoffFreq = midHighCrossover->get();
-       AP2.setCutoffFrequency(midHighCutoffFreq);
-       LP2.setCutoffFrequency(midHighCutoffFreq);
-       HP2.setCutoffFrequency(midHighCutoffFreq);
+/** The two halves of a left/right pair of speakers, which form one channel group. */
+bool isSpeakerPair(juce::AudioChannelSet::ChannelType first, juce::AudioChannelSet::ChannelType second)
+{
+    using Set = juce::AudioChannelSet;
     
-    inputGain.setGainDecibels(inputGainParam->get());
-      outputGain.setGainDecibels(outputGainParam->get());
+    static constexpr std::pair<Set::ChannelType, Set::ChannelType> pairs[]
+    {
+        { Set::left,             Set::right },
+        { Set::leftCentre,       Set::rightCentre },
+        { Set::leftSurround,     Set::rightSurround },
+        { Set::leftSurroundSide, Set::rightSurroundSide },
+        { Set::leftSurroundRear, Set::rightSurroundRear },
+        { Set::wideLeft,         Set::wideRight },
+        { Set::topFrontLeft,     Set::topFrontRight },
+        { Set::topRearLeft,      Set::topRearRight }
+    };
     
+    return std::any_of(std::begin(pairs), std::end(pairs), [=](const auto& p) { return p.first == first && p.second == second; });
+}
 }
 
-void SimpleMbCompAudioProcessor::splitBands(const juce::AudioBuffer<float> &inputBuffer)
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::prepareChain(ProcessingChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec, const juce::dsp::ProcessSpec& splitSpec)
 {
-    for (auto& fb : filterBuffers)
+    auto types = getChannelLayoutOfBus(false, 0).getChannelTypes();
+    auto numChannels = static_cast<int>(spec.numChannels);
+    
+    chain.channelGroups.clear();
+    
+    for (auto ch = 0; ch < numChannels;)
     {
-        fb = inputBuffer;
+        auto isPair = ch + 1 < juce::jmin(numChannels, types.size()) && isSpeakerPair(types[ch], types[ch + 1]);
+        
+        typename ProcessingChain<SampleType>::ChannelGroup group;
+        group.firstChannel = ch;
+        group.numChannels = isPair ? 2 : 1;
+        chain.channelGroups.push_back(std::move(group));
+        
+        ch += isPair ? 2 : 1;
     }
     
-    auto fb0Block = juce::dsp::AudioBlock<float>(filterBuffers[0]);
-    auto fb1Block = juce::dsp::AudioBlock<float>(filterBuffers[1]);
-    auto fb2Block = juce::dsp::AudioBlock<float>(filterBuffers[2]);
+    auto detectionMode = static_cast<DetectionMode>(channelLinkParam->getIndex());
+    auto levelDetector = static_cast<LevelDetector>(detectorParam->getIndex());
+    auto lookaheadSamples = getLookaheadSamples(spec.sampleRate);
     
-    auto fb0Ctx = juce::dsp::ProcessContextReplacing<float>(fb0Block);
-    auto fb1Ctx = juce::dsp::ProcessContextReplacing<float>(fb1Block);
-    auto fb2Ctx = juce::dsp::ProcessContextReplacing<float>(fb2Block);
+    for (auto& group : chain.channelGroups)
+    {
+        auto groupSpec = spec;
+        groupSpec.numChannels = static_cast<juce::uint32>(group.numChannels);
+        
+        for (size_t band = 0; band < Params::NumBands; ++band)
+        {
+            auto& comp = group.compressors[band];
+            comp.prepare(bandParams[band], morph, band, groupSpec, getMaxLookaheadSamples(spec.sampleRate));
+            comp.setLookahead(lookaheadSamples);
+            comp.setDetectionMode(detectionMode);
+            comp.setLevelDetector(levelDetector);
+        }
+    }
+    
+    chain.crossover.setOrder(static_cast<CrossoverOrder>(crossoverSlopeParam->getIndex()));
+    
+    //set before prepare, so the first block starts at the current frequencies instead of gliding there
+    for (size_t j = 0; j < Params::NumCrossovers; ++j)
+        chain.crossover.setCrossoverFrequency(j, getCrossoverFrequency(j));
     
-    LP1.process(fb0Ctx);
-    AP2.process(fb0Ctx);
+    chain.crossover.prepare(splitSpec);
+    
+    for (auto& buffer : chain.filterBuffers)
+    {
+        buffer.setSize(static_cast<int>(splitSpec.numChannels), static_cast<int>(splitSpec.maximumBlockSize));
+    }
     
-    HP1.process(fb1Ctx);
-    filterBuffers[2] = filterBuffers[1];
+    chain.inputGain.prepare(spec);
+    chain.outputGain.prepare(spec);
     
-    LP2.process(fb1Ctx);
-    HP2.process(fb2Ctx);
+    chain.inputGain.setRampDurationSeconds(0.05);
+    chain.outputGain.setRampDurationSeconds(0.05);
 }
 
-void SimpleMbCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void SimpleMbCompAudioProcessor::updateState()
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
+    using namespace Params;
     
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    applyPendingProgram();
     
-
-    updateState();
+    auto changes = parameterChanges.takeChanges();
     
-    applyGain(buffer, inputGain);
+    //adds whatever the morph moved, and only that
+    auto morphing = morph.update(morphParam->get(), changes);
     
-    splitBands(buffer);
+    if ( ! changes.any() )
+        return;
     
-    for (size_t i = 0; i < filterBuffers.size(); i++)
+    for (size_t band = 0; band < NumBands; band++)
     {
-        compressors[i].process(filterBuffers[i]);
+        if (changes.test(bandParam(BandParam::Attack, band)) || changes.test(bandParam(BandParam::Release, band))
+            || changes.test(bandParam(BandParam::Threshold, band)) || changes.test(bandParam(BandParam::Ratio, band))
+            || changes.test(bandParam(BandParam::Knee, band)))
+        {
+            forEachChain([band](auto& chain)
+            {
+                for (auto& group : chain.channelGroups)
+                    group.compressors[band].updateCompressorSettings();
+            });
+        }
     }
     
+    if (changes.test(ChannelLink))
+    {
+        auto mode = static_cast<DetectionMode>(channelLinkParam->getIndex());
+        
+        forEachChain([mode](auto& chain) { chain.forEachCompressor([mode](auto& comp) { comp.setDetectionMode(mode); }); });
+    }
     
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
+    if (changes.test(Detector))
+    {
+        auto detector = static_cast<LevelDetector>(detectorParam->getIndex());
+        
+        forEachChain([detector](auto& chain) { chain.forEachCompressor([detector](auto& comp) { comp.setLevelDetector(detector); }); });
+    }
     
-    buffer.clear();
+    for (size_t j = 0; j < NumCrossovers; ++j)
+    {
+        if (changes.test(crossoverFreq(j)))
+        {
+            auto frequency = getCrossoverFrequency(j);
+            
+            forEachChain([j, frequency](auto& chain) { chain.crossover.setCrossoverFrequency(j, frequency); });
+            linearPhaseCrossover.setCrossoverFrequency(j, frequency);
+        }
+    }
+    
+    if (changes.test(CrossoverSlope))
+    {
+        auto order = static_cast<CrossoverOrder>(crossoverSlopeParam->getIndex());
+        
+        forEachChain([order](auto& chain) { chain.crossover.setOrder(order); });
+    }
     
-    auto addFilterBand = [nc = numChannels, ns = numSamples](auto& inputBuffer, const auto& source)
+    if (changes.test(CrossoverMode))
     {
-        for (auto i = 0; i < nc; i++)
+        auto linearPhase = crossoverModeParam->getIndex() == 1;
+        
+        //the engine that takes over starts from a clean history
+        if (linearPhase != useLinearPhase)
         {
-            inputBuffer.addFrom(i, 0, source, i, 0, ns);
+            if (linearPhase)
+                linearPhaseCrossover.reset();
+            else
+                forEachChain([](auto& chain) { chain.crossover.reset(); });
         }
-    };
+        
+        useLinearPhase = linearPhase;
+    }
+    
+    if (changes.test(GainIn))
+    {
+        auto gain = morphing ? morph.getValue(GainIn) : inputGainParam->get();
+        forEachChain([gain](auto& chain) { chain.inputGain.setGainDecibels(gain); });
+    }
+    
+    if (changes.test(GainOut))
+    {
+        auto gain = morphing ? morph.getValue(GainOut) : outputGainParam->get();
+        forEachChain([gain](auto& chain) { chain.outputGain.setGainDecibels(gain); });
+    }
+    
+    if (changes.test(Lookahead))
+    {
+        auto lookahead = getLookaheadSamples(getSampleRate());
+        
+        forEachChain([lookahead](auto& chain) { chain.forEachCompressor([lookahead](auto& comp) { comp.setLookahead(lookahead); }); });
+    }
+    
+    if ((changes.test(Lookahead) || changes.test(CrossoverMode))
+        && getTotalLatencySamples(getSampleRate()) != getLatencySamples())
+    {
+        updatePending.store(true);
+    }
+}
+
+float SimpleMbCompAudioProcessor::getCrossoverFrequency(size_t crossover) const
+{
+    return morph.isActive() ? morph.getValue(Params::crossoverFreq(crossover)) : crossoverFreqs[crossover]->get();
+}
+
+int SimpleMbCompAudioProcessor::getMaxLookaheadSamples(double sampleRate)
+{
+    return static_cast<int>(std::ceil(Params::MaxLookaheadMs / 1000.0 * sampleRate));
+}
+
+int SimpleMbCompAudioProcessor::getLookaheadSamples(double sampleRate) const
+{
+    return juce::jmin(getMaxLookaheadSamples(sampleRate), juce::roundToInt(lookaheadParam->get() / 1000.0 * sampleRate));
+}
+
+int SimpleMbCompAudioProcessor::getTotalLatencySamples(double sampleRate) const
+{
+    auto crossoverLatency = crossoverModeParam->getIndex() == 1 ? linearPhaseCrossover.getLatencySamples() : 0;
+    return getLookaheadSamples(sampleRate) + crossoverLatency;
+}
+
+void SimpleMbCompAudioProcessor::timerCallback()
+{
+    if (! updatePending.exchange(false))
+        return;
+    
+    auto requested = requestedProgram.exchange(-1);
+    if (requested >= 0)
+        loadProgram(requested);
+    
+    if (programChanged.exchange(false))
+    {
+        //the audio thread set the values without telling anyone
+        for (auto* param : parameters)
+            param->sendValueChangedMessageToListeners(param->getValue());
+        
+        updateHostDisplay();
+    }
+    
+    if (workerPool != nullptr)
+        (*workerPool)->wakeUp();
     
+    setLatencySamples(getTotalLatencySamples(getSampleRate()));
+}
+
+bool SimpleMbCompAudioProcessor::loadPresetBank(const juce::File& file)
+{
+    auto bank = std::make_unique<PresetBank>();
+    if (! bank->open(file))
+        return false;
     
+    //the audio thread only ever sees copies, so the old bank can go straight away
+    presetBank = std::move(bank);
+    currentProgram.store(0);
+    updateHostDisplay();
+    
+    return true;
+}
+
+void SimpleMbCompAudioProcessor::loadProgram(int index)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
     
+    if (presetBank == nullptr || ! juce::isPositiveAndBelow(index, presetBank->getNumPresets()))
+        return;
+    
+    auto& slot = programSlots[static_cast<size_t>(programBack)];
+    slot.program = index;
+    
+    for (size_t i = 0; i < Params::NumParams; ++i)
+    {
+        auto* param = parameters[i];
+        auto value = 0.f;
+        
+        slot.values[i] = presetBank->getValue(index, i, value) ? param->convertTo0to1(value) : param->getDefaultValue();
+    }
+    
+    programBack = programMiddle.exchange(programBack | newProgramBit, std::memory_order_acq_rel) & ~newProgramBit;
+}
+
+void SimpleMbCompAudioProcessor::applyPendingProgram()
+{
+    if ((programMiddle.load(std::memory_order_acquire) & newProgramBit) == 0)
+        return;
+    
+    programFront = programMiddle.exchange(programFront, std::memory_order_acq_rel) & ~newProgramBit;
+    const auto& slot = programSlots[static_cast<size_t>(programFront)];
+    
+    //setValue skips the listeners, which lock. That is only true because the parameters
+    //are plain AudioParameterFloat/Choice/Bool, and it means the APVTS value tree and its
+    //raw values stay stale until timerCallback() sends the change messages. The DSP,
+    //getStateInformation() and the analyzer all read the parameters themselves instead
+    for (size_t i = 0; i < Params::NumParams; ++i)
+        parameters[i]->setValue(slot.values[i]);
+    
+    currentProgram.store(slot.program);
+    parameterChanges.markAllChanged();
+    programChanged.store(true);
+    updatePending.store(true);
+}
+
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::splitBands(ProcessingChain<SampleType>& chain, juce::AudioBuffer<SampleType>& inputBuffer, juce::AudioBuffer<SampleType>& sidechain)
+{
+    auto numChannels = inputBuffer.getNumChannels() + numKeyChannels;
+    auto numSamples = inputBuffer.getNumSamples();
+    
+    jassert(numChannels <= maxSplitChannels && numKeyChannels <= sidechain.getNumChannels());
+    
+    //one split for both: the key's channels fill crossover lanes the main channels leave
+    //free and land behind them in the band buffers
+    std::array<SampleType*, maxSplitChannels> channels {};
+    
+    for (auto ch = 0; ch < inputBuffer.getNumChannels(); ++ch)
+        channels[static_cast<size_t>(ch)] = inputBuffer.getWritePointer(ch);
+    
+    for (auto ch = 0; ch < numKeyChannels; ++ch)
+        channels[static_cast<size_t>(inputBuffer.getNumChannels() + ch)] = sidechain.getWritePointer(ch);
+    
+    juce::AudioBuffer<SampleType> input(channels.data(), numChannels, numSamples);
+    
+    //resize the band views without touching the storage allocated in prepareToPlay;
+    //process() never hands over more than internalBlockSize samples
+    jassert(numSamples <= internalBlockSize);
+    
+    for (auto& fb : chain.filterBuffers)
+    {
+        fb.setSize(numChannels, numSamples, false, false, true);
+    }
+    
+    if (useLinearPhase)
+    {
+        linearPhaseCrossover.process(input, chain.filterBuffers);
+    }
+    else if (shouldRunInParallel(numSamples, numChannels))
+    {
+        //each task is one register of the tree: a run of bands of one or more channels
+        chain.crossover.process(input, chain.filterBuffers, [this](int numTasks, auto& task)
+        {
+            auto realtimeTask = [&task](int index)
+            {
+                RealtimeGuard::ScopedRealtimeSection realtimeSection;
+                task(index);
+            };
+            
+            (*workerPool)->run(numTasks, realtimeTask);
+        });
+    }
+    else
+    {
+        chain.crossover.process(input, chain.filterBuffers);
+    }
+}
+
+SimpleMbCompAudioProcessor::BandFlags SimpleMbCompAudioProcessor::getAudibleBands() const
+{
     //=========================================================== SOLO/MUTE FUNCTIONALITY
+    BandFlags audible {};
     auto bandsAreSoloed = false;
     
-    for(auto& comp : compressors)
+    for(auto& comp : bandParams)
     {
         if(comp.solo->get())
         {
@@ -319,219 +632,417 @@ void SimpleMbCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
             break;
         }
     }
-
-    if  (bandsAreSoloed)
+    
+    for (size_t i = 0; i < bandParams.size(); i++)
     {
-        for (size_t i = 0; i < compressors.size(); i++)
-        {
-            auto& comp = compressors[i];
-            if (comp.solo->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
-        }
+        auto& comp = bandParams[i];
+        audible[i] = bandsAreSoloed ? comp.solo->get() : ! comp.mute->get();
     }
-    else
+    
+    return audible;
+}
+
+SimpleMbCompAudioProcessor::BandFlags SimpleMbCompAudioProcessor::getKeyedBands(int numSidechainChannels) const
+{
+    BandFlags keyed {};
+    
+    //without a connected sidechain every band keeps listening to itself
+    if (numSidechainChannels > 0)
     {
-        for (size_t i = 0; i < compressors.size(); i++)
-        {
-            auto& comp = compressors[i];
-            if ( ! comp.mute->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
-        }
+        for (size_t i = 0; i < bandParams.size(); i++)
+            keyed[i] = bandParams[i].sidechain->get();
     }
     
-    applyGain(buffer, outputGain);
+    return keyed;
 }
 
-//==============================================================================
-bool SimpleMbCompAudioProcessor::hasEditor() const
+template <typename SampleType>
+bool SimpleMbCompAudioProcessor::isSilent(const juce::AudioBuffer<SampleType>& buffer) const
 {
-    return true; // (change this to false if you choose to not supply an editor)
+    for (auto ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) > silenceThreshold)
+            return false;
+    }
+    
+    return true;
 }
 
-juce::AudioProcessorEditor* SimpleMbCompAudioProcessor::createEditor()
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::sumBands(ProcessingChain<SampleType>& chain, juce::AudioBuffer<SampleType>& buffer, const BandFlags& audible)
 {
-    return new juce::GenericAudioProcessorEditor(*this);
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = buffer.getNumChannels();
+    
+    buffer.clear();
+    
+    //bands that just got muted or unmuted are faded over the block instead of switched
+    for (size_t i = 0; i < chain.filterBuffers.size(); i++)
+    {
+        if ( ! audible[i] && ! bandWasAudible[i] )
+            continue;
+        
+        auto startGain = SampleType(bandWasAudible[i] ? 1 : 0);
+        auto endGain = SampleType(audible[i] ? 1 : 0);
+        
+        for (auto ch = 0; ch < numChannels; ch++)
+        {
+            if (startGain == endGain)
+                buffer.addFrom(ch, 0, chain.filterBuffers[i], ch, 0, numSamples);
+            else
+                buffer.addFromWithRamp(ch, 0, chain.filterBuffers[i].getReadPointer(ch), numSamples, startGain, endGain);
+        }
+    }
 }
 
-//==============================================================================
-void SimpleMbCompAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+void SimpleMbCompAudioProcessor::processBlock (juce::AudioBuffer<float>& hostBuffer, juce::MidiBuffer&)
 {
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    process(hostBuffer, floatChain);
 }
 
-void SimpleMbCompAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+void SimpleMbCompAudioProcessor::processBlock (juce::AudioBuffer<double>& hostBuffer, juce::MidiBuffer&)
 {
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid())
-    {
-        apvts.replaceState(tree);
-    }
+    process(hostBuffer, doubleChain);
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout SimpleMbCompAudioProcessor::createParameterLayout()
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::process(juce::AudioBuffer<SampleType>& hostBuffer, ProcessingChain<SampleType>& chain)
 {
-    APVTS::ParameterLayout layout;
+    RealtimeGuard::ScopedRealtimeSection realtimeSection;
+    BlockProfiler::ScopedBlock profiledBlock(profiler, stageTimings, hostBuffer.getNumSamples(), getSampleRate());
     
-    using namespace juce;
-    using namespace Params;
-    
-    
-    const auto& params = GetParams();
-    auto attackReleaseRange = NormalisableRange<float>(5, 500, 1, 1);
-    auto gainRange = NormalisableRange<float>(-24.f, 24.f, 0.5f, 1);
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     
-    //********************************** COMPRESSORS PARAMETERS
-    //*********************************************************GAIN/OUTPUT
-    
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Gain_In),
-                                                     params.at(Names::Gain_In),
-                                                     gainRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Gain_Out),
-                                                     params.at(Names::Gain_Out),
-                                                     gainRange,
-                                                     0));
-    
-    
-    //*************************************************************** THRESHOLD
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        hostBuffer.clear (i, 0, hostBuffer.getNumSamples());
     
-    auto thresholdRange =  NormalisableRange<float>(-60, 12, 1, 1);
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Threshold_Low_band),
-                                                     params.at(Names::Threshold_Low_band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Threshold_Mid_band),
-                                                     params.at(Names::Threshold_Mid_band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Threshold_High_band),
-                                                     params.at(Names::Threshold_High_band),
-                                                     thresholdRange,
-                                                     0));
-          
-    //**************************************************************** ATTACK
+    //some hosts call processBlock before prepareToPlay; with no chunk size the loop below
+    //would never advance, so the input passes through untouched
+    jassert(internalBlockSize > 0);
+    if (internalBlockSize <= 0)
+        return;
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Attack_Low_Band),
-                                                     params.at(Names::Attack_Low_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Attack_Mid_Band),
-                                                     params.at(Names::Attack_Mid_Band),
-                                                     attackReleaseRange,
-                                                     50));
+    //the host buffer holds the main bus followed by the sidechain, which is only listened to
+    auto buffer = getBusBuffer(hostBuffer, false, 0);
+    auto sidechain = getBusBuffer(hostBuffer, true, 1);
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Attack_High_Band),
-                                                     params.at(Names::Attack_High_Band),
-                                                     attackReleaseRange,
-                                                     50));
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    stageTimings.clear();
+   #endif
     
-    //***************************************************************** RELEASE
+    {
+        ScopedStageTimer timer(stageTimings, StageTimings::updateState);
+        updateState();
+    }
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Release_Low_Band),
-                                                     params.at(Names::Release_Low_Band),
-                                                     attackReleaseRange,
-                                                     250));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Release_Mid_Band),
-                                                     params.at(Names::Release_Mid_Band),
-                                                     attackReleaseRange,
-                                                     250));
+    //views into the host buffer, so a block of any size is split without copying or allocating
+    for (auto start = 0; start < buffer.getNumSamples(); start += internalBlockSize)
+    {
+        auto numSamples = juce::jmin(internalBlockSize, buffer.getNumSamples() - start);
+        
+        juce::AudioBuffer<SampleType> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSamples);
+        juce::AudioBuffer<SampleType> keyChunk(sidechain.getArrayOfWritePointers(), sidechain.getNumChannels(), start, numSamples);
+        
+        processChunk(chunk, keyChunk, chain);
+    }
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Release_High_Band),
-                                                     params.at(Names::Release_High_Band),
-                                                     attackReleaseRange,
-                                                     250));
+    //workers that parked while nothing ran are woken from a thread that may block
+    if (workerPool != nullptr && (*workerPool)->takeWakeUpRequest())
+    {
+        if (isNonRealtime())
+            (*workerPool)->wakeUp();
+        else
+            updatePending.store(true);
+    }
+}
 
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::processChunk(juce::AudioBuffer<SampleType>& buffer, juce::AudioBuffer<SampleType>& sidechain, ProcessingChain<SampleType>& chain)
+{
+    samplesProcessed += buffer.getNumSamples();
+    preAnalyzerFifo.push(buffer);
     
-    //**************************************************************** RATIO
+    //once the input has been silent for longer than the filter and envelope tails,
+    //the output is silent too and the whole chain can be skipped
+    if (computeElision && isSilent(buffer))
+    {
+        silentSamples += buffer.getNumSamples();
+        
+        if (silentSamples > silenceHoldSamples)
+        {
+            buffer.clear();
+            publishMeters(chain, {});
+            postAnalyzerFifo.push(buffer);
+            return;
+        }
+    }
+    else
+    {
+        if (silentSamples > silenceHoldSamples)
+        {
+            chain.crossover.reset();
+            linearPhaseCrossover.reset();
+            chain.forEachCompressor([](auto& comp) { comp.reset(); });
+        }
+        
+        silentSamples = 0;
+    }
     
-    auto choices = std::vector<double> {1, 1.5, 2, 3, 4, 5, 6, 7, 8, 10, 15, 20, 50, 100};
-    juce::StringArray sa;
-    for (auto choice:choices)
     {
-        sa.add( String(choice, 1));
+        ScopedStageTimer timer(stageTimings, StageTimings::inputGain);
+        applyGain(buffer, chain.inputGain);
     }
     
-    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Ratio_Low_Band),
-                                                      params.at(Names::Ratio_Low_Band),
-                                                      sa,
-                                                      3));
+    //the key is only split while some band listens to it
+    auto keyed = getKeyedBands(sidechain.getNumChannels());
+    auto isKeyed = std::find(keyed.begin(), keyed.end(), true) != keyed.end();
+    numKeyChannels = isKeyed ? sidechain.getNumChannels() : 0;
     
-    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Ratio_Mid_Band),
-                                                      params.at(Names::Ratio_Mid_Band),
-                                                      sa,
-                                                      3));
+    //the crossover always runs so every band's filter state stays continuous
+    {
+        ScopedStageTimer timer(stageTimings, StageTimings::splitBands);
+        splitBands(chain, buffer, sidechain);
+    }
     
-    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Ratio_High_Band),
-                                                      params.at(Names::Ratio_High_Band),
-                                                      sa,
-                                                      3));
+    auto audible = getAudibleBands();
+    BandFlags processed {}, resetFirst {};
     
+    for (size_t i = 0; i < chain.filterBuffers.size(); i++)
+    {
+        //a band that can't be heard skips its compressor, except for the block it fades out in.
+        //It comes back with a fresh envelope rather than one frozen when it went quiet.
+        if (computeElision && ! audible[i])
+        {
+            processed[i] = bandWasAudible[i];
+        }
+        else
+        {
+            resetFirst[i] = computeElision && ! bandWasAudible[i];
+            processed[i] = true;
+        }
+    }
     
-    //**************************************************************** BYPASS
+    compressBands(chain, processed, resetFirst, keyed);
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Bypassed_Low_Band),
-                                                    params.at(Names::Bypassed_Low_Band),
-                                                    false));
+    {
+        ScopedStageTimer timer(stageTimings, StageTimings::summing);
+        sumBands(chain, buffer, audible);
+    }
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Bypassed_Mid_Band),
-                                                    params.at(Names::Bypassed_Mid_Band),
-                                                    false));
+    bandWasAudible = audible;
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Bypassed_High_Band),
-                                                    params.at(Names::Bypassed_High_Band),
-                                                    false));
+    {
+        ScopedStageTimer timer(stageTimings, StageTimings::outputGain);
+        applyGain(buffer, chain.outputGain);
+    }
     
+    publishMeters(chain, processed);
+    postAnalyzerFifo.push(buffer);
+}
+
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::compressBands(ProcessingChain<SampleType>& chain, const BandFlags& processed, const BandFlags& resetFirst, const BandFlags& keyed)
+{
+    //one task per band of each group; every task has its own compressor and channels
+    auto compressBand = [this, &chain, &processed, &resetFirst, &keyed](int task)
+    {
+        //pool workers run this on the audio thread's behalf
+        RealtimeGuard::ScopedRealtimeSection realtimeSection;
+        
+        auto& group = chain.channelGroups[static_cast<size_t>(task) / Params::NumBands];
+        auto i = static_cast<size_t>(task) % Params::NumBands;
+        
+        if ( ! processed[i] )
+            return;
+        
+        ScopedStageTimer timer(group.timings, StageTimings::firstBand + static_cast<int>(i));
+        
+        auto& comp = group.compressors[i];
+        if (resetFirst[i])
+            comp.reset();
+        
+        //refers to the group's channels of the band, nothing is copied or allocated
+        auto& band = chain.filterBuffers[i];
+        auto numMainChannels = band.getNumChannels() - numKeyChannels;
+        jassert(group.firstChannel + group.numChannels <= numMainChannels);
+        
+        juce::AudioBuffer<SampleType> channels(band.getArrayOfWritePointers() + group.firstChannel, group.numChannels, band.getNumSamples());
+        
+        if (keyed[i])
+        {
+            //a key laid out like the main bus keys each group from its own channels
+            auto matchesLayout = numKeyChannels == numMainChannels;
+            auto firstKeyChannel = numMainChannels + (matchesLayout ? group.firstChannel : 0);
+            
+            juce::AudioBuffer<SampleType> key(band.getArrayOfWritePointers() + firstKeyChannel,
+                                              matchesLayout ? group.numChannels : numKeyChannels,
+                                              band.getNumSamples());
+            comp.process(channels, &key);
+        }
+        else
+        {
+            comp.process(channels);
+        }
+    };
     
-    //**************************************************************** MUTE
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    for (auto& group : chain.channelGroups)
+        group.timings.clear();
+   #endif
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Mute_Low_Band),
-                                                    params.at(Names::Mute_Low_Band),
-                                                    false));
+    auto numTasks = static_cast<int>(chain.channelGroups.size() * Params::NumBands);
+    auto& firstBand = chain.filterBuffers.front();
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Mute_Mid_Band),
-                                                    params.at(Names::Mute_Mid_Band),
-                                                    false));
+    if (shouldRunInParallel(firstBand.getNumSamples(), firstBand.getNumChannels()))
+        (*workerPool)->run(numTasks, compressBand);
+    else
+        for (auto t = 0; t < numTasks; ++t)
+            compressBand(t);
+    
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    //time spent on each band summed over the groups, whichever thread ran them
+    for (const auto& group : chain.channelGroups)
+        for (size_t i = 0; i < Params::NumBands; ++i)
+            stageTimings.ticks[StageTimings::firstBand + i] += group.timings.ticks[StageTimings::firstBand + i];
+   #endif
+}
+
+template <typename SampleType>
+void SimpleMbCompAudioProcessor::publishMeters(const ProcessingChain<SampleType>& chain, const BandFlags& processed)
+{
+    MeterFrame frame;
+    frame.endSample = samplesProcessed;
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Mute_High_Band),
-                                                    params.at(Names::Mute_High_Band),
-                                                    false));
+    //bands whose compressor was skipped read as silent
+    for (size_t i = 0; i < Params::NumBands; i++)
+    {
+        if ( ! processed[i] )
+            continue;
+        
+        //the loudest peaks and deepest reduction of any group, and the RMS over all channels
+        auto& levels = frame.bands[i];
+        auto inputSquares = 0.f, outputSquares = 0.f;
+        auto numChannels = 0;
+        
+        for (const auto& group : chain.channelGroups)
+        {
+            const auto& l = group.compressors[i].getLevels();
+            
+            levels.inputPeak = juce::jmax(levels.inputPeak, l.inputPeak);
+            levels.outputPeak = juce::jmax(levels.outputPeak, l.outputPeak);
+            levels.gainReductionDb = juce::jmin(levels.gainReductionDb, l.gainReductionDb);
+            inputSquares += l.inputRms * l.inputRms * group.numChannels;
+            outputSquares += l.outputRms * l.outputRms * group.numChannels;
+            numChannels += group.numChannels;
+        }
+        
+        if (numChannels > 0)
+        {
+            levels.inputRms = std::sqrt(inputSquares / numChannels);
+            levels.outputRms = std::sqrt(outputSquares / numChannels);
+        }
+    }
     
+    meterFifo.push(frame);
+}
+
+//==============================================================================
+bool SimpleMbCompAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* SimpleMbCompAudioProcessor::createEditor()
+{
+    return new SimpleMbCompAudioProcessorEditor(*this);
+}
+
+//==============================================================================
+void SimpleMbCompAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    StateFormat::write(destData, parameters);
+}
+
+void SimpleMbCompAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    if (StateFormat::read(data, sizeInBytes, parameters))
+        return;
     
-    //**************************************************************** SOLO
+    //sessions saved before the binary format hold the whole value tree
+    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+    if (tree.isValid())
+    {
+        apvts.replaceState(tree);
+    }
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout SimpleMbCompAudioProcessor::createParameterLayout(ParameterPointers* parameters)
+{
+    APVTS::ParameterLayout layout;
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Solo_Low_Band),
-                                                    params.at(Names::Solo_Low_Band),
-                                                    false));
+    using namespace juce;
+    using namespace Params;
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Solo_Mid_Band),
-                                                    params.at(Names::Solo_Mid_Band),
-                                                    false));
+    std::array<bool, NumParams> added {};
     
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Solo_High_Band),
-                                                    params.at(Names::Solo_High_Band),
-                                                    false));
+    auto add = [&layout, &added, parameters](size_t index)
+    {
+        jassert(! added[index]);
+        added[index] = true;
+        
+        const auto& descriptor = getDescriptors()[index];
+        const auto& name = getName(index);
+        std::unique_ptr<RangedAudioParameter> param;
+        
+        switch (descriptor.kind)
+        {
+            case Kind::Float:
+                param = std::make_unique<AudioParameterFloat>(name, name, descriptor.range, descriptor.defaultValue);
+                break;
+            case Kind::Choice:
+                param = std::make_unique<AudioParameterChoice>(name, name, descriptor.getChoices(), static_cast<int>(descriptor.defaultValue));
+                break;
+            case Kind::Bool:
+                param = std::make_unique<AudioParameterBool>(name, name, descriptor.defaultValue != 0);
+                break;
+        }
+        
+        if (parameters != nullptr)
+            (*parameters)[index] = param.get();
+        
+        layout.add(std::move(param));
+    };
     
+    //hosts that address parameters by position keep seeing the original plugin's
+    //parameters where they always were: the gains, the band parameters kind by kind,
+    //then the crossovers. Every later parameter goes after those, in the order it was added
+    add(GainIn);
+    add(GainOut);
     
-    //**************************************************************** BANDS CROSSOVERS
+    for (auto param : { BandParam::Threshold, BandParam::Attack, BandParam::Release, BandParam::Ratio,
+                        BandParam::Bypassed, BandParam::Mute, BandParam::Solo })
+        for (size_t b = 0; b < NumBands; ++b)
+            add(bandParam(param, b));
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Low_Mid_Crossover_Freq),
-                                                     params.at(Names::Low_Mid_Crossover_Freq),
-                                                     NormalisableRange<float>(20, 999, 1, 1),
-                                                     400));
+    for (size_t j = 0; j < NumCrossovers; ++j)
+        add(crossoverFreq(j));
     
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Mid_High_Crossover_Freq),
-                                                     params.at(Names::Mid_High_Crossover_Freq),
-                                                     NormalisableRange<float>(1000, 20000, 1, 1),
-                                                     2000));
+    add(Lookahead);
+    add(CrossoverMode);
+    add(ChannelLink);
     
+    for (auto param : { BandParam::Sidechain, BandParam::Knee })
+        for (size_t b = 0; b < NumBands; ++b)
+            add(bandParam(param, b));
     
+    add(Detector);
+    add(Morph);
+    add(CrossoverSlope);
     
+    jassert(std::all_of(added.begin(), added.end(), [](bool a) { return a; }));
     
     return layout;
 }
@@ -9,124 +9,183 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Params.h"
+#include "CrossoverEngine.h"
+#include "CompressorEngine.h"
+#include "LinearPhaseCrossover.h"
+#include "StageTimings.h"
+#include "BlockProfiler.h"
+#include "RealtimeGuard.h"
+#include "BandMeters.h"
+#include "AnalyzerFifo.h"
+#include "RealtimeWorkerPool.h"
+#include "StateFormat.h"
+#include "PresetBank.h"
+#include "PresetMorph.h"
 
-namespace Params
-{
-enum Names
+/*
+    Turns parameter change notifications into dirty bits, one per parameter index.
+    It listens to the parameters themselves, not through the value tree, so nothing is
+    looked up by ID. Listeners may fire on any thread; the audio thread collects the
+    bits once per block and only updates the DSP objects whose parameters actually moved.
+*/
+class ParameterChangeTracker
 {
-    Low_Mid_Crossover_Freq,
-    Mid_High_Crossover_Freq,
-    
-    Threshold_Low_band,
-    Threshold_Mid_band,
-    Threshold_High_band,
+public:
+    static constexpr size_t numWords = (Params::NumParams + 63) / 64;
     
-    Attack_Low_Band,
-    Attack_Mid_Band,
-    Attack_High_Band,
+    /** A snapshot of the dirty bits taken at the start of a block. */
+    struct Changes
+    {
+        std::array<uint64_t, numWords> words {};
+        
+        bool any() const
+        {
+            return std::any_of(words.begin(), words.end(), [](auto w) { return w != 0; });
+        }
+        
+        bool test(size_t index) const { return (words[index / 64] & bit(index)) != 0; }
+        void set(size_t index) { words[index / 64] |= bit(index); }
+    };
     
-    Release_Low_Band,
-    Release_Mid_Band,
-    Release_High_Band,
+    explicit ParameterChangeTracker(const std::array<juce::RangedAudioParameter*, Params::NumParams>& params) : parameters(params)
+    {
+        for (size_t i = 0; i < listeners.size(); ++i)
+        {
+            listeners[i].word = &changes[i / 64];
+            listeners[i].mask = bit(i);
+            parameters[i]->addListener(&listeners[i]);
+        }
+        
+        markAllChanged();
+    }
     
-    Ratio_Low_Band,
-    Ratio_Mid_Band,
-    Ratio_High_Band,
+    ~ParameterChangeTracker()
+    {
+        for (size_t i = 0; i < listeners.size(); ++i)
+            parameters[i]->removeListener(&listeners[i]);
+    }
     
-    Bypassed_Low_Band,
-    Bypassed_Mid_Band,
-    Bypassed_High_Band,
+    static constexpr uint64_t bit(size_t index) { return uint64_t(1) << (index % 64); }
     
-    Mute_Low_Band,
-    Mute_Mid_Band,
-    Mute_High_Band,
+    void markAllChanged()
+    {
+        for (auto& w : changes)
+            w.store(~uint64_t(0), std::memory_order_release);
+    }
     
-    Solo_Low_Band,
-    Solo_Mid_Band,
-    Solo_High_Band,
+    /** Returns the parameters that changed since the last call and clears them. */
+    Changes takeChanges()
+    {
+        Changes c;
+        for (size_t w = 0; w < numWords; ++w)
+            c.words[w] = changes[w].exchange(0, std::memory_order_acquire);
+        
+        return c;
+    }
     
-    Gain_In,
-    Gain_Out,
-};
-inline const std::map<Names,juce::String>& GetParams()
-{
-    static std::map<Names,juce::String> params =
+private:
+    struct Listener : juce::AudioProcessorParameter::Listener
     {
-        {Low_Mid_Crossover_Freq, "Low-Mid Crossover Freq"},
-        {Mid_High_Crossover_Freq, "Mid-High Crossover Freq"},
-        {Threshold_Low_band, "Threshold Low Band"},
-        {Threshold_Mid_band, "Threshold Mid Band"},
-        {Threshold_High_band, "Threshold High Band"},
-        {Attack_Low_Band, "Attack Low Band"},
-        {Attack_Mid_Band, "Attack Mid Band"},
-        {Attack_High_Band, "Attack High Band"},
-        {Release_Low_Band, "Release Low Band"},
-        {Release_Mid_Band, "Release Mid Band"},
-        {Release_High_Band, "Release High Band"},
-        {Ratio_Low_Band, "Ratio Low Band"},
-        {Ratio_Mid_Band, "Ratio Mid Band"},
-        {Ratio_High_Band, "Ratio High Band"},
-        {Bypassed_Low_Band, "Bypassed Low Band"},
-        {Bypassed_Mid_Band, "Bypassed Mid Band"},
-        {Bypassed_High_Band, "Bypassed High Band"},
-        {Mute_Low_Band, "Mute Low Band"},
-        {Mute_Mid_Band, "Mute Mid Band"},
-        {Mute_High_Band, "Mute High Band"},
-        {Solo_Low_Band, "Solo Low Band"},
-        {Solo_Mid_Band, "Solo Mid Band"},
-        {Solo_High_Band, "Solo High Band"},
-        {Gain_In, "Gain In"},
-        {Gain_Out, "Gain Out"},
+        void parameterValueChanged(int, float) override
+        {
+            word->fetch_or(mask, std::memory_order_release);
+        }
+        
+        void parameterGestureChanged(int, bool) override {}
+        
+        std::atomic<uint64_t>* word = nullptr;
+        uint64_t mask = 0;
     };
     
-    return params;
-}
-}
+    const std::array<juce::RangedAudioParameter*, Params::NumParams>& parameters;
+    std::array<Listener, Params::NumParams> listeners;
+    std::array<std::atomic<uint64_t>, numWords> changes;
+    
+    JUCE_DECLARE_NON_COPYABLE(ParameterChangeTracker)
+};
 
 
-struct CompressorBand
+/** The parameters of one band. Each channel group runs its own compressor for the band,
+    and they all read these. */
+struct BandParameters
 {
-public:
     juce::AudioParameterFloat* attack {nullptr};
     juce::AudioParameterFloat* release {nullptr};
     juce::AudioParameterFloat* threshold {nullptr};
     juce::AudioParameterChoice* ratio {nullptr};
+    juce::AudioParameterFloat* knee {nullptr};
     juce::AudioParameterBool* bypassed {nullptr};
     juce::AudioParameterBool* mute {nullptr};
     juce::AudioParameterBool* solo {nullptr};
-    
-    void prepare(const juce::dsp::ProcessSpec& spec)
+    juce::AudioParameterBool* sidechain {nullptr};
+};
+
+/** One band of one channel group: a CompressorEngine driven by the band's parameters,
+    or by the morph between two snapshots while one is running. */
+template <typename SampleType>
+struct CompressorBand
+{
+public:
+    void prepare(const BandParameters& parameters, const PresetMorph& presetMorph, size_t bandIndex,
+                 const juce::dsp::ProcessSpec& spec, int maxLookaheadSamples)
     {
-        compressor.prepare(spec);
+        params = &parameters;
+        morph = &presetMorph;
+        band = bandIndex;
+        updateCompressorSettings();
+        engine.prepare(spec, maxLookaheadSamples);
     }
     
+    void reset() { engine.reset(); }
+    
+    void setLookahead(int numSamples) { engine.setLookahead(numSamples); }
+    void setDetectionMode(DetectionMode mode) { engine.setDetectionMode(mode); }
+    void setLevelDetector(LevelDetector detector) { engine.setLevelDetector(detector); }
+    
     void updateCompressorSettings()
     {
-         compressor.setAttack(attack->get());
-         compressor.setRelease(release->get());
-         compressor.setThreshold(threshold->get());
-         compressor.setRatio(ratio->getCurrentChoiceName().getFloatValue());
+        if (morph->isActive())
+        {
+            using namespace Params;
+            
+            engine.setAttack(static_cast<SampleType>(morph->getValue(bandParam(BandParam::Attack, band))));
+            engine.setRelease(static_cast<SampleType>(morph->getValue(bandParam(BandParam::Release, band))));
+            engine.setThreshold(static_cast<SampleType>(morph->getValue(bandParam(BandParam::Threshold, band))));
+            engine.setRatio(static_cast<SampleType>(morph->getValue(bandParam(BandParam::Ratio, band))));
+            engine.setKnee(static_cast<SampleType>(morph->getValue(bandParam(BandParam::Knee, band))));
+            return;
+        }
+        
+         engine.setAttack(static_cast<SampleType>(params->attack->get()));
+         engine.setRelease(static_cast<SampleType>(params->release->get()));
+         engine.setThreshold(static_cast<SampleType>(params->threshold->get()));
+         engine.setRatio(static_cast<SampleType>(Params::RatioChoices[static_cast<size_t>(params->ratio->getIndex())]));
+         engine.setKnee(static_cast<SampleType>(params->knee->get()));
     }
     
-    void process(juce::AudioBuffer<float>& buffer)
+    void process(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>* key = nullptr)
     {
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        auto context = juce::dsp::ProcessContextReplacing<float>(block);
-        
-        context.isBypassed = bypassed->get();
-        
-        compressor.process(context);
+        engine.setBypassed(params->bypassed->get());
+        engine.process(buffer, key);
     }
     
+    /** Levels of the last processed block. */
+    const BandLevels& getLevels() const { return engine.getLevels(); }
+    
 private:
-    juce::dsp::Compressor<float> compressor;
+    const BandParameters* params = nullptr;
+    const PresetMorph* morph = nullptr;
+    size_t band = 0;
+    CompressorEngine<SampleType> engine;
 };
 
 
 //==============================================================================
 /**
 */
-class SimpleMbCompAudioProcessor  : public juce::AudioProcessor
+class SimpleMbCompAudioProcessor  : public juce::AudioProcessor,
+                                    private juce::Timer
 {
 public:
     //==============================================================================
@@ -142,6 +201,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    /** Double buffers run through their own double precision chain, not a conversion. */
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -167,11 +230,68 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
     
     using APVTS = juce::AudioProcessorValueTreeState;
-    static APVTS::ParameterLayout createParameterLayout();
+    using ParameterPointers = std::array<juce::RangedAudioParameter*, Params::NumParams>;
+    
+    /** Makes every parameter from Params::getDescriptors(); a pointer to each one is
+        written to parameters by index, when given. */
+    static APVTS::ParameterLayout createParameterLayout(ParameterPointers* parameters = nullptr);
+    
+private:
+    //filled in by createParameterLayout, so it must come before apvts
+    ParameterPointers parameters {};
+    
+public:
+    APVTS apvts { *this, nullptr, "Parameters", createParameterLayout(&parameters) };
+    
+    /** Per-stage timings of the last processed block, see SIMPLEMBCOMP_STAGE_TIMING. */
+    const StageTimings& getStageTimings() const { return stageTimings; }
+    
+    /** Load histogram and stage totals over all blocks, see BlockProfiler. */
+    BlockProfiler& getProfiler() { return profiler; }
+    
+    /** Skips the compressors of bands that can't be heard and the whole chain on long
+        silent stretches. On by default; switching it off is only useful for measuring. */
+    void setComputeElisionEnabled(bool shouldBeEnabled) { computeElision = shouldBeEnabled; }
     
-    APVTS apvts { *this, nullptr, "Parameters", createParameterLayout() };
+    /** The most samples the chain processes at once, from the next prepareToPlay on. Host
+        blocks of any size are split into chunks of at most this size, so a host that sends
+        more than it announced never makes the audio thread allocate. 0, the default,
+        uses the block size given to prepareToPlay. */
+    void setInternalBlockSize(int numSamples) { requestedInternalBlockSize = numSamples; }
+    int getInternalBlockSize() const { return internalBlockSize; }
+    
+    /** Which live blocks go to the worker pool: those big enough to pay for it, as by
+        default, every one or none. Offline renders always use the pool. From the next
+        prepareToPlay on; the other modes are only useful for measuring the default. */
+    enum class LiveParallelism { bySize, always, never };
+    void setLiveParallelism(LiveParallelism mode) { liveParallelism = mode; }
+    
+    /** Whether the last prepareToPlay kept a worker pool with any workers in it; live, it
+        lets go of the pool when the workers can't run at realtime priority. */
+    bool isUsingWorkerPool() const { return workerPool != nullptr && (*workerPool)->getNumWorkers() > 0; }
+    
+    /** Stores the current settings as snapshot A or B. Once both are stored the Morph
+        parameter crossfades between them, see PresetMorph. Message thread. */
+    void storeMorphSnapshot(PresetMorph::Slot slot) { morph.store(slot, parameters); }
+    bool hasMorphSnapshot(PresetMorph::Slot slot) const { return morph.hasSnapshot(slot); }
+    
+    /** Hands the morphed settings back to their own parameters. */
+    void clearMorphSnapshots() { morph.clear(); }
+    
+    /** Maps a bank written by PresetBank::write, whose presets become the host's programs.
+        Message thread only; returns false if the file isn't a bank. */
+    bool loadPresetBank(const juce::File& file);
+    
+    /** Per-band levels, one frame per processed block. See MeterFifo for who may read it. */
+    MeterFifo& getMeterFifo() { return meterFifo; }
+    
+    /** Input and output samples for the spectrum analyzer, only filled while it's enabled. */
+    AnalyzerFifo& getPreAnalyzerFifo() { return preAnalyzerFifo; }
+    AnalyzerFifo& getPostAnalyzerFifo() { return postAnalyzerFifo; }
 
 private:
+    ParameterChangeTracker parameterChanges { parameters };
+    
 //    juce::dsp::Compressor<float> compressor;
 //
 //    juce::AudioParameterFloat* attack {nullptr};
@@ -179,37 +299,201 @@ private:
 //    juce::AudioParameterFloat* threshold {nullptr};
 //    juce::AudioParameterChoice* ratio {nullptr};
 //    juce::AudioParameterBool* bypassed {nullptr};
-    std::array<CompressorBand, 3> compressors;
-    CompressorBand& lowBandComp = compressors[0];
-    CompressorBand& midBandComp = compressors[1];
-    CompressorBand& highBandComp = compressors[2];
+    using BandFlags = std::array<bool, Params::NumBands>;
     
-    using Filter = juce::dsp::LinkwitzRileyFilter<float>;
-    //     fc0      fc1
-    Filter LP1,     AP2,
-           HP1,     LP2,
-                    HP2;
+    std::array<BandParameters, Params::NumBands> bandParams;
     
-   
+    /*
+        Everything that holds samples, once per precision. Both chains are prepared, so
+        the host can switch precision between prepareToPlay calls; only the one matching
+        the processBlock it calls ever runs.
+    */
+    template <typename SampleType>
+    struct ProcessingChain
+    {
+        using Crossover = CrossoverEngine<Params::NumBands, SampleType>;
+        
+        /*
+            Consecutive channels with their own compressors: a left/right pair of the layout,
+            or a single channel such as the centre or LFE. Groups, and the bands within a
+            group, share no state, so they can be compressed in parallel; Channel Link
+            decides how a group's channels drive its detectors.
+        */
+        struct ChannelGroup
+        {
+            int firstChannel = 0;
+            int numChannels = 0;
+            std::array<CompressorBand<SampleType>, Params::NumBands> compressors;
+            StageTimings timings;
+        };
+        
+        Crossover crossover;
+        typename Crossover::BandBuffers filterBuffers;
+        std::vector<ChannelGroup> channelGroups;
+        juce::dsp::Gain<SampleType> inputGain, outputGain;
+        
+        template <typename Function>
+        void forEachCompressor(Function&& f)
+        {
+            for (auto& group : channelGroups)
+                for (auto& comp : group.compressors)
+                    f(comp);
+        }
+    };
     
-    juce::AudioParameterFloat* lowMidCrossover {nullptr};
-    juce::AudioParameterFloat* midHighCrossover {nullptr};
-    std::array<juce::AudioBuffer <float>, 3> filterBuffers;
+    ProcessingChain<float> floatChain;
+    ProcessingChain<double> doubleChain;
+    
+    template <typename Function>
+    void forEachChain(Function&& f)
+    {
+        f(floatChain);
+        f(doubleChain);
+    }
+    
+    juce::AudioParameterChoice* channelLinkParam {nullptr};
+    juce::AudioParameterChoice* detectorParam {nullptr};
+    
+    //held only while this instance can use it, see prepareToPlay
+    std::unique_ptr<juce::SharedResourcePointer<RealtimeWorkerPool>> workerPool;
+    static constexpr int minParallelBlockSize = 1024;
+    static constexpr int minParallelSamples = 4096;     // block size times channels
+    LiveParallelism liveParallelism = LiveParallelism::bySize;
+    
+    //offline renders always spread the split and the bands over the pool; live blocks
+    //only once there is enough work to pay for handing it out. The block size floor keeps
+    //ordinary live blocks serial even with many channels, so the audio thread only ever
+    //waits on a worker where the block is long enough to absorb a late one
+    bool canRunInParallel(int numSamples, int numChannels) const
+    {
+        if (isNonRealtime() || liveParallelism == LiveParallelism::always)
+            return true;
+        
+        return liveParallelism == LiveParallelism::bySize
+            && numSamples >= minParallelBlockSize && numSamples * numChannels >= minParallelSamples;
+    }
+    
+    //live, the audio thread waits on the workers, which is only safe at realtime priority
+    bool shouldRunInParallel(int numSamples, int numChannels) const
+    {
+        return workerPool != nullptr && canRunInParallel(numSamples, numChannels)
+            && (isNonRealtime() || (*workerPool)->hasRealtimeWorkers());
+    }
+    
+    template <typename SampleType>
+    void prepareChain(ProcessingChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec, const juce::dsp::ProcessSpec& splitSpec);
+    
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& hostBuffer, ProcessingChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    void processChunk(juce::AudioBuffer<SampleType>& buffer, juce::AudioBuffer<SampleType>& sidechain, ProcessingChain<SampleType>& chain);
+    
+    int requestedInternalBlockSize = 0;
+    int internalBlockSize = 0;
+    
+    template <typename SampleType>
+    void compressBands(ProcessingChain<SampleType>& chain, const BandFlags& processed, const BandFlags& resetFirst, const BandFlags& keyed);
+    
+    LinearPhaseCrossover<Params::NumBands> linearPhaseCrossover;
+    juce::AudioParameterChoice* crossoverModeParam {nullptr};
+    juce::AudioParameterChoice* crossoverSlopeParam {nullptr};
+    bool useLinearPhase = false;
+    
+    std::array<juce::AudioParameterFloat*, Params::NumCrossovers> crossoverFreqs {};
+    float getCrossoverFrequency(size_t crossover) const;
+    
+    juce::AudioParameterFloat* morphParam {nullptr};
+    PresetMorph morph;
     
-    juce::dsp::Gain<float> inputGain, outputGain;
     juce::AudioParameterFloat* inputGainParam {nullptr};
     juce::AudioParameterFloat* outputGainParam {nullptr};
     
-    template <typename T, typename U>
-    void applyGain(T& buffer, U& gain)
+    juce::AudioParameterFloat* lookaheadParam {nullptr};
+    static int getMaxLookaheadSamples(double sampleRate);
+    int getLookaheadSamples(double sampleRate) const;
+    int getTotalLatencySamples(double sampleRate) const;
+    
+    //the host is told about latency changes and program switches from the message thread,
+    //and parked pool workers are woken there. The audio thread only raises updatePending,
+    //because triggerAsyncUpdate() posts a message and may lock or allocate doing so
+    std::atomic<bool> updatePending { false };
+    void timerCallback() override;
+    
+    /*
+        Only the message thread reads the bank. A program change copies the preset's
+        normalised values into a preallocated slot there, and the audio thread copies the
+        newest slot into the parameters at the start of the next block, so it never
+        touches the mapped file; the glides smooth the jump. Listeners, including the host,
+        are told afterwards from timerCallback.
+        
+        The three slots are handed over like the kernels in LinearPhaseCrossover: the
+        message thread fills the back one and swaps it into the middle, the audio thread
+        swaps a new middle to the front. Neither side ever waits for the other.
+        
+        Hosts may call setCurrentProgram from any thread; away from the message thread it
+        only leaves the index in requestedProgram for timerCallback.
+    */
+    struct ProgramSlot
+    {
+        int program = 0;
+        std::array<float, Params::NumParams> values {};
+    };
+    
+    static constexpr int newProgramBit = 4;
+    
+    std::unique_ptr<PresetBank> presetBank;
+    std::array<ProgramSlot, 3> programSlots;
+    int programBack = 2;                    // message thread
+    std::atomic<int> programMiddle { 1 };
+    int programFront = 0;                   // audio thread
+    std::atomic<int> requestedProgram { -1 };
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<bool> programChanged { false };
+    void loadProgram(int index);
+    void applyPendingProgram();
+    
+    template <typename SampleType>
+    void applyGain(juce::AudioBuffer<SampleType>& buffer, juce::dsp::Gain<SampleType>& gain)
     {
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        auto ctx = juce::dsp::ProcessContextReplacing<float>(block);
+        auto block = juce::dsp::AudioBlock<SampleType>(buffer);
+        auto ctx = juce::dsp::ProcessContextReplacing<SampleType>(block);
         gain.process(ctx);
     }
     
+    StageTimings stageTimings;
+    BlockProfiler profiler;
+    static constexpr int profileExportIntervalMs = 5000;
+    
+    MeterFifo meterFifo;
+    AnalyzerFifo preAnalyzerFifo, postAnalyzerFifo;
+    juce::int64 samplesProcessed = 0;
+    template <typename SampleType>
+    void publishMeters(const ProcessingChain<SampleType>& chain, const BandFlags& processed);
+    
     void updateState();
-    void splitBands(const juce::AudioBuffer<float>& inputBuffer);
+    bool computeElision = true;
+    BandFlags bandWasAudible {};
+    
+    static constexpr float silenceThreshold = 1.0e-6f;  // -120 dBFS
+    static constexpr double silenceHoldSeconds = 1.0;   // longer than any release or filter tail
+    juce::int64 silentSamples = 0;
+    juce::int64 silenceHoldSamples = 0;
+    
+    BandFlags getAudibleBands() const;
+    template <typename SampleType>
+    bool isSilent(const juce::AudioBuffer<SampleType>& buffer) const;
+    
+    //the sidechain's channels follow the main ones in the crossovers and filterBuffers
+    static constexpr int maxSplitChannels = 24;         // a 7.1.4 bus keyed by another
+    int numKeyChannels = 0;
+    BandFlags getKeyedBands(int numSidechainChannels) const;
+    
+    template <typename SampleType>
+    void splitBands(ProcessingChain<SampleType>& chain, juce::AudioBuffer<SampleType>& inputBuffer, juce::AudioBuffer<SampleType>& sidechain);
+    
+    template <typename SampleType>
+    void sumBands(ProcessingChain<SampleType>& chain, juce::AudioBuffer<SampleType>& buffer, const BandFlags& audible);
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleMbCompAudioProcessor)
 };
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Params.h"
+
+/*
+    A file of presets that is memory-mapped rather than parsed. Every preset is a record
+    of the same size, so finding one is a multiplication:
+
+        uint32 magic "SMBB", uint16 version, uint16 numColumns, uint32 numPresets
+        numColumns x uint32 ID hash                 the parameter in each column
+        numPresets x { char name[32], numColumns x float32 plain value }
+
+    all little-endian. Columns are matched to parameters by ID hash when the bank is
+    opened; parameters without one take their default.
+
+    After opening, the bank is read-only. Reading it can fault pages in from disk, so
+    keep it off the audio thread: the processor copies a preset's values out on the
+    message thread and hands the audio thread only the copy.
+*/
+class PresetBank
+{
+public:
+    static constexpr juce::uint32 magic = 0x424d4253;      // "SMBB" in the file
+    static constexpr juce::uint16 version = 1;
+    static constexpr int nameSize = 32;
+
+    struct Preset
+    {
+        juce::String name;
+        std::array<float, Params::NumParams> values {};     // plain values by parameter index
+    };
+
+    /** Writes a bank with one column for every parameter, in index order. */
+    static bool write(const juce::File& file, const std::vector<Preset>& presets)
+    {
+        juce::MemoryBlock data;
+
+        {
+            juce::MemoryOutputStream out(data, false);
+            out.writeInt(static_cast<int>(magic));
+            out.writeShort(static_cast<short>(version));
+            out.writeShort(static_cast<short>(Params::NumParams));
+            out.writeInt(static_cast<int>(presets.size()));
+
+            for (size_t i = 0; i < Params::NumParams; ++i)
+                out.writeInt(static_cast<int>(Params::getIdHash(i)));
+
+            for (const auto& preset : presets)
+            {
+                //truncated to fit, always zero terminated
+                char name[nameSize] {};
+                preset.name.copyToUTF8(name, nameSize);
+                out.write(name, nameSize);
+
+                for (auto value : preset.values)
+                    out.writeFloat(value);
+            }
+        }
+
+        return file.replaceWithData(data.getData(), data.getSize());
+    }
+
+    /** Maps a bank written by write(). Returns false if it can't be read. */
+    bool open(const juce::File& file)
+    {
+        mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+        auto* data = static_cast<const char*>(mappedFile->getData());
+        auto size = mappedFile->getSize();
+
+        if (data == nullptr || size < headerSize || juce::ByteOrder::littleEndianInt(data) != magic
+            || juce::ByteOrder::littleEndianShort(data + 4) == 0)
+        {
+            mappedFile.reset();
+            return false;
+        }
+
+        numColumns = juce::ByteOrder::littleEndianShort(data + 6);
+        auto presetsInFile = static_cast<int>(juce::ByteOrder::littleEndianInt(data + 8));
+        recordSize = nameSize + 4 * static_cast<size_t>(numColumns);
+        records = data + headerSize + 4 * static_cast<size_t>(numColumns);
+
+        if (size < static_cast<size_t>(records - data) + recordSize * static_cast<size_t>(presetsInFile))
+        {
+            mappedFile.reset();
+            return false;
+        }
+
+        numPresets = presetsInFile;
+        columns.fill(-1);
+
+        for (size_t c = 0; c < numColumns; ++c)
+        {
+            auto index = Params::findIndex(juce::ByteOrder::littleEndianInt(data + headerSize + 4 * c), c);
+
+            if (index < Params::NumParams)
+                columns[index] = static_cast<int>(c);
+        }
+
+        return true;
+    }
+
+    int getNumPresets() const { return numPresets; }
+
+    juce::String getName(int preset) const
+    {
+        jassert(juce::isPositiveAndBelow(preset, numPresets));
+        auto* name = getRecord(preset);
+        return juce::String::fromUTF8(name, static_cast<int>(std::find(name, name + nameSize, 0) - name));
+    }
+
+    /** The plain value of a parameter in a preset; false if the bank has no column for it.
+        Doesn't lock or allocate. */
+    bool getValue(int preset, size_t index, float& value) const
+    {
+        jassert(juce::isPositiveAndBelow(preset, numPresets));
+
+        auto column = columns[index];
+        if (column < 0)
+            return false;
+
+        auto bits = juce::ByteOrder::littleEndianInt(getRecord(preset) + nameSize + 4 * static_cast<size_t>(column));
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+private:
+    static constexpr size_t headerSize = 12;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* records = nullptr;
+    size_t recordSize = 0;
+    size_t numColumns = 0;
+    int numPresets = 0;
+    std::array<int, Params::NumParams> columns {};
+
+    const char* getRecord(int preset) const
+    {
+        return records + recordSize * static_cast<size_t>(preset);
+    }
+};
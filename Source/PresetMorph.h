@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    PresetMorph.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Params.h"
+
+/*
+    Crossfades the continuous settings between two stored snapshots, A and B.
+
+    A snapshot holds a value for every parameter index; only the morphable ones are used
+    (thresholds, attack, release, ratio, knee, crossovers and the gains), and a ratio is
+    kept as the ratio itself rather than a choice index, so it moves smoothly too. Once
+    both slots are filled the morph takes over those settings from the parameters.
+
+    The message thread stores snapshots value by value into atomics and bumps a counter.
+    The audio thread copies them into plain arrays when the counter moves and then
+    interpolates the whole flattened set in SIMD registers each time the position
+    changes. A block that copies a snapshot while it's being stored may see part of it;
+    the next block sees the rest, and the glides hide the difference.
+*/
+class PresetMorph
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numValues = (Params::NumParams + Vec::SIMDNumElements - 1) / Vec::SIMDNumElements * Vec::SIMDNumElements;
+
+    enum Slot
+    {
+        slotA,
+        slotB,
+        numSlots
+    };
+
+    static bool isMorphable(size_t index)
+    {
+        using namespace Params;
+
+        if (index < NumCrossovers || index == GainIn || index == GainOut)
+            return true;
+
+        if (index >= GainIn)
+            return false;
+
+        auto kind = static_cast<BandParam>((index - NumCrossovers) / NumBands);
+        return kind == BandParam::Threshold || kind == BandParam::Attack || kind == BandParam::Release
+            || kind == BandParam::Ratio || kind == BandParam::Knee;
+    }
+
+    PresetMorph()
+    {
+        for (size_t i = 0; i < Params::NumParams; ++i)
+            morphable[i] = isMorphable(i);
+    }
+
+    /** Message thread: the slot takes the parameters' current values. */
+    void store(Slot slot, const std::array<juce::RangedAudioParameter*, Params::NumParams>& parameters)
+    {
+        for (size_t i = 0; i < Params::NumParams; ++i)
+        {
+            auto* param = parameters[i];
+            auto value = param->convertFrom0to1(param->getValue());
+
+            if (isRatio(i))
+                value = Params::RatioChoices[static_cast<size_t>(juce::roundToInt(value))];
+
+            snapshots[slot][i].store(value, std::memory_order_relaxed);
+        }
+
+        filled[slot].store(true, std::memory_order_relaxed);
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    /** Message thread: empties both slots, which hands the settings back to the parameters. */
+    void clear()
+    {
+        for (auto& f : filled)
+            f.store(false, std::memory_order_relaxed);
+
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    bool hasSnapshot(Slot slot) const { return filled[slot].load(std::memory_order_relaxed); }
+
+    /** Audio thread: whether the last update() found both slots filled. */
+    bool isActive() const { return active; }
+
+    /** Audio thread: moves to position, 0 being A and 1 B, and sets the bit of every value
+        that moved in changes; all morphable ones when the morph starts or stops. Returns
+        whether the morph is on, in which case getValue() replaces those parameters. */
+    template <typename Changes>
+    bool update(float position, Changes& changes)
+    {
+        auto currentVersion = version.load(std::memory_order_acquire);
+        auto reload = currentVersion != loadedVersion;
+
+        if (reload)
+        {
+            loadedVersion = currentVersion;
+
+            auto wasActive = active;
+            active = hasSnapshot(slotA) && hasSnapshot(slotB);
+
+            if (active)
+            {
+                for (size_t i = 0; i < Params::NumParams; ++i)
+                {
+                    a[i] = snapshots[slotA][i].load(std::memory_order_relaxed);
+                    b[i] = snapshots[slotB][i].load(std::memory_order_relaxed);
+                }
+            }
+
+            if (active != wasActive)
+            {
+                for (size_t i = 0; i < Params::NumParams; ++i)
+                {
+                    if (morphable[i])
+                        changes.set(i);
+                }
+            }
+        }
+
+        if (! active)
+            return false;
+
+        if (! reload && position == lastPosition)
+            return true;
+
+        lastPosition = position;
+
+        auto t = Vec::expand(position);
+        for (size_t k = 0; k < numValues; k += Vec::SIMDNumElements)
+        {
+            auto va = Vec::fromRawArray(a.data() + k);
+            auto vb = Vec::fromRawArray(b.data() + k);
+            (va + (vb - va) * t).copyToRawArray(morphed.data() + k);
+        }
+
+        //only what actually moved is passed on, so a crossover that is the same in A and B
+        //never has its coefficients recomputed
+        for (size_t i = 0; i < Params::NumParams; ++i)
+        {
+            if (morphable[i] && morphed[i] != applied[i])
+            {
+                applied[i] = morphed[i];
+                changes.set(i);
+            }
+        }
+
+        return true;
+    }
+
+    /** The morphed value of a morphable parameter; a Ratio is the ratio, not its index. */
+    float getValue(size_t index) const { return applied[index]; }
+
+private:
+    std::array<std::array<std::atomic<float>, Params::NumParams>, numSlots> snapshots {};
+    std::array<std::atomic<bool>, numSlots> filled {};
+    std::atomic<juce::uint32> version { 0 };
+
+    //audio thread only
+    alignas(Vec::SIMDRegisterSize) std::array<float, numValues> a {};
+    alignas(Vec::SIMDRegisterSize) std::array<float, numValues> b {};
+    alignas(Vec::SIMDRegisterSize) std::array<float, numValues> morphed {};
+    std::array<float, Params::NumParams> applied {};
+    std::array<bool, Params::NumParams> morphable {};
+    juce::uint32 loadedVersion = 0;
+    float lastPosition = -1.f;
+    bool active = false;
+
+    static bool isRatio(size_t index)
+    {
+        auto first = Params::bandParam(Params::BandParam::Ratio, 0);
+        return index >= first && index < first + Params::NumBands;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(PresetMorph)
+};
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+    Replaces the global operator new/delete so allocations and frees made inside a
+    realtime section are reported. Compiles to nothing when the guard is off.
+
+    Only the renderer links this file. A plugin binary must not replace them, since on
+    some platforms the replacement is seen by the host and every other plugin it loads.
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if SIMPLEMBCOMP_REALTIME_GUARD
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+void* checkedAllocation(std::size_t size)
+{
+    RealtimeGuard::checkAllocation();
+
+    if (auto* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+//freeing can take the allocator's lock just like allocating
+void checkedFree(void* p) noexcept
+{
+    if (p != nullptr)
+        RealtimeGuard::checkAllocation();
+
+    std::free(p);
+}
+}
+
+void* operator new(std::size_t size)                                     { return checkedAllocation(size); }
+void* operator new[](std::size_t size)                                   { return checkedAllocation(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept     { RealtimeGuard::checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept   { RealtimeGuard::checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void operator delete(void* p) noexcept                                   { checkedFree(p); }
+void operator delete[](void* p) noexcept                                 { checkedFree(p); }
+void operator delete(void* p, std::size_t) noexcept                      { checkedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept                    { checkedFree(p); }
+
+#endif
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef SIMPLEMBCOMP_REALTIME_GUARD
+ #if JUCE_DEBUG
+  #define SIMPLEMBCOMP_REALTIME_GUARD 1
+ #else
+  #define SIMPLEMBCOMP_REALTIME_GUARD 0
+ #endif
+#endif
+
+/*
+    Catches heap allocations and locks on the audio thread in debug builds.
+
+    Threads doing audio work mark themselves with a ScopedRealtimeSection. While a
+    section is open, every lock taken through CheckedCriticalSection counts a violation
+    and hits a jassert. The renderer (RealtimeGuard.cpp) and the benchmark executable
+    (AllocationCounter.cpp) also replace operator new and delete to call
+    checkAllocation(), so allocations on the audio path are caught there; the plugin
+    itself leaves the global allocator alone.
+
+    Set SIMPLEMBCOMP_REALTIME_GUARD to 0 or 1 to override the debug-only default.
+*/
+namespace RealtimeGuard
+{
+#if SIMPLEMBCOMP_REALTIME_GUARD
+inline thread_local int realtimeDepth = 0;
+inline thread_local bool reporting = false;
+inline std::atomic<juce::int64> violationCount { 0 };
+
+inline void reportViolation()
+{
+    violationCount.fetch_add(1, std::memory_order_relaxed);
+
+    //the assertion logs, which may allocate in turn
+    if (! reporting)
+    {
+        reporting = true;
+        jassertfalse;
+        reporting = false;
+    }
+}
+
+inline void checkAllocation()   { if (realtimeDepth > 0) reportViolation(); }
+inline void checkBlocking()     { if (realtimeDepth > 0) reportViolation(); }
+
+class ScopedRealtimeSection
+{
+public:
+    ScopedRealtimeSection()  { ++realtimeDepth; }
+    ~ScopedRealtimeSection() { --realtimeDepth; }
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+};
+#else
+inline void checkAllocation() {}
+inline void checkBlocking() {}
+
+class ScopedRealtimeSection
+{
+public:
+    ScopedRealtimeSection() {}
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+};
+#endif
+
+/** Allocations and locks seen inside a realtime section since startup; always 0 with the guard off. */
+inline juce::int64 getViolationCount()
+{
+   #if SIMPLEMBCOMP_REALTIME_GUARD
+    return violationCount.load(std::memory_order_relaxed);
+   #else
+    return 0;
+   #endif
+}
+
+/** A CriticalSection that reports being entered from a realtime section. */
+class CheckedCriticalSection  : public juce::CriticalSection
+{
+public:
+    void enter() const noexcept
+    {
+        checkBlocking();
+        juce::CriticalSection::enter();
+    }
+
+    void exit() const noexcept { juce::CriticalSection::exit(); }
+};
+
+using ScopedLock = juce::GenericScopedLock<CheckedCriticalSection>;
+}
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+    A few preallocated threads that help the audio thread through a batch of independent
+    tasks. Handing out work is a handful of atomics: nothing locks, allocates or waits
+    for a thread to wake up. The calling thread claims tasks itself, so a batch finishes
+    even if no worker picks anything up, and it only ever waits for tasks a worker is
+    already running.
+
+    Shared by every instance through juce::SharedResourcePointer, which an instance only
+    holds while its layout or an offline render can use the pool, so sessions that never
+    need it start no threads. One batch runs at a time; a caller that finds the pool busy,
+    or no worker awake, simply runs its tasks on its own.
+
+    The caller waits for tasks a worker has claimed, so on the audio thread a worker must
+    not be preempted by anything the audio thread wouldn't be. Workers therefore run at
+    realtime audio priority; where the system refuses that, hasRealtimeWorkers() is false
+    and the pool is only good for offline work.
+
+    This is deliberately not a work-stealing scheduler. A batch is a dozen or so tasks of
+    about the same size, the registers of the crossover or the bands of the compressors,
+    so one shared counter that everybody claims the next index from balances them as well
+    as per-thread queues would, without the queues or their memory ordering. For the same
+    reason the caller waits for the last claimed tasks by yielding rather than sleeping on
+    an event: waking it would take a lock, and the wait is never longer than one task.
+*/
+class RealtimeWorkerPool
+{
+public:
+    RealtimeWorkerPool()
+    {
+        auto numWorkers = juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+
+        for (auto i = 0; i < numWorkers; ++i)
+        {
+            workers.add(new Worker(*this));
+
+           #if JUCE_VERSION >= 0x70003
+            realtimeWorkers = workers.getLast()->startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10)) && realtimeWorkers;
+           #else
+            workers.getLast()->startThread(juce::Thread::realtimeAudioPriority);
+           #endif
+        }
+    }
+
+    ~RealtimeWorkerPool()
+    {
+        for (auto* worker : workers)
+            worker->signalThreadShouldExit();
+
+        workers.clear();
+    }
+
+    int getNumWorkers() const { return workers.size(); }
+
+    /** Whether every worker got realtime priority, which the audio thread needs to wait on one. */
+    bool hasRealtimeWorkers() const { return realtimeWorkers; }
+
+    /** Wakes the parked workers. This signals an event, so it's for the message thread or
+        an offline render, never the audio thread. */
+    void wakeUp()
+    {
+        for (auto* worker : workers)
+            worker->notify();
+    }
+
+    /** True, once, after run() found every worker parked; the owner then calls wakeUp()
+        from a thread that may block. */
+    bool takeWakeUpRequest()
+    {
+        return wakeUpRequested.exchange(false, std::memory_order_relaxed);
+    }
+
+    /** Calls task(i) for every i in [0, numTasks) and returns once all of them are done.
+        The tasks must not touch each other's data. */
+    template <typename Task>
+    void run(int numTasks, Task& task)
+    {
+        auto invoke = [](void* context, int index) { (*static_cast<Task*>(context))(index); };
+
+        auto noneAwake = numAwake.load(std::memory_order_relaxed) == 0;
+
+        if (noneAwake && ! workers.isEmpty())
+            wakeUpRequested.store(true, std::memory_order_relaxed);
+
+        if (numTasks <= 1 || noneAwake || busy.exchange(true, std::memory_order_acquire))
+        {
+            for (auto i = 0; i < numTasks; ++i)
+                invoke(&task, i);
+
+            return;
+        }
+
+        batchFunction.store(invoke, std::memory_order_relaxed);
+        batchContext.store(&task, std::memory_order_relaxed);
+        batchSize.store(numTasks, std::memory_order_relaxed);
+        remaining.store(numTasks, std::memory_order_relaxed);
+        nextTask.store(0, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_release);
+
+        runTasks();
+
+        //every index is claimed by now, so this only waits for the tasks still running
+        while (remaining.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+
+        nextTask.store(closed, std::memory_order_relaxed);
+        busy.store(false, std::memory_order_release);
+    }
+
+private:
+    static constexpr int maxWorkers = 3;
+    static constexpr juce::uint32 spinMilliseconds = 2;    // stay awake this long after a batch
+    static constexpr juce::uint32 parkMilliseconds = 1000; // and park this long after the last one
+
+    //far above any batch size, so a worker that arrives late claims nothing
+    static constexpr int closed = std::numeric_limits<int>::max() / 2;
+
+    using TaskFunction = void (*)(void*, int);
+
+    std::atomic<bool> busy { false };
+    std::atomic<juce::uint32> generation { 0 };
+    std::atomic<TaskFunction> batchFunction { nullptr };
+    std::atomic<void*> batchContext { nullptr };
+    std::atomic<int> batchSize { 0 };
+    std::atomic<int> nextTask { closed };
+    std::atomic<int> remaining { 0 };
+    std::atomic<int> numAwake { 0 };
+    std::atomic<bool> wakeUpRequested { false };
+    bool realtimeWorkers = true;
+
+    void runTasks()
+    {
+        //a claimed index keeps the batch open, so the batch fields can't change under it
+        for (;;)
+        {
+            auto index = nextTask.fetch_add(1, std::memory_order_acq_rel);
+
+            if (index >= batchSize.load(std::memory_order_relaxed))
+                return;
+
+            batchFunction.load(std::memory_order_relaxed)(batchContext.load(std::memory_order_relaxed), index);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    /*
+        While batches keep coming, workers poll rather than wait on an event, since
+        signalling one would mean a lock on the audio thread. They spin for a moment after
+        each batch and otherwise poll every millisecond; one that wakes up mid-batch joins
+        in, one that wakes up late finds nothing left to claim. A second without a batch
+        and they park on the thread's event until wakeUp().
+    */
+    struct Worker  : juce::Thread
+    {
+        explicit Worker(RealtimeWorkerPool& p) : juce::Thread("Realtime worker"), pool(p) {}
+
+        ~Worker() override
+        {
+            stopThread(1000);
+        }
+
+        void run() override
+        {
+            auto seen = pool.generation.load(std::memory_order_acquire);
+            auto lastBatch = juce::Time::getMillisecondCounter();
+            pool.numAwake.fetch_add(1, std::memory_order_relaxed);
+
+            while (! threadShouldExit())
+            {
+                auto current = pool.generation.load(std::memory_order_acquire);
+                auto idleMilliseconds = juce::Time::getMillisecondCounter() - lastBatch;
+
+                if (current != seen)
+                {
+                    seen = current;
+                    pool.runTasks();
+                    lastBatch = juce::Time::getMillisecondCounter();
+                }
+                else if (idleMilliseconds < spinMilliseconds)
+                {
+                    std::this_thread::yield();
+                }
+                else if (idleMilliseconds < parkMilliseconds)
+                {
+                    sleep(1);
+                }
+                else
+                {
+                    pool.numAwake.fetch_sub(1, std::memory_order_relaxed);
+                    wait(-1);
+                    pool.numAwake.fetch_add(1, std::memory_order_relaxed);
+
+                    seen = pool.generation.load(std::memory_order_acquire);
+                    lastBatch = juce::Time::getMillisecondCounter();
+                }
+            }
+
+            pool.numAwake.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        RealtimeWorkerPool& pool;
+    };
+
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeWorkerPool)
+};
@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+#include "PluginProcessor.h"
+#include "FastMath.h"
+
+namespace
+{
+constexpr float minFrequency = 20.f;
+constexpr float maxFrequency = 20000.f;
+constexpr float topDecibels = 0.f;
+}
+
+//==============================================================================
+SpectrumSource::SpectrumSource(AnalyzerFifo& f) : fifo(f)
+{
+}
+
+void SpectrumSource::setBounds(juce::Rectangle<float> newBounds)
+{
+    const RealtimeGuard::ScopedLock sl(pathLock);
+    bounds = newBounds;
+}
+
+juce::Path SpectrumSource::getPath() const
+{
+    const RealtimeGuard::ScopedLock sl(pathLock);
+    return path;
+}
+
+void SpectrumSource::update()
+{
+    auto numNew = fifo.pull(incoming.data(), static_cast<int>(incoming.size()));
+
+    if (numNew == 0)
+        return;
+
+    //slide the newest samples into the analysis window
+    if (numNew >= fftSize)
+    {
+        std::copy(incoming.begin() + (numNew - fftSize), incoming.begin() + numNew, history.begin());
+    }
+    else
+    {
+        std::copy(history.begin() + numNew, history.end(), history.begin());
+        std::copy(incoming.begin(), incoming.begin() + numNew, history.end() - numNew);
+    }
+
+    std::copy(history.begin(), history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    //a full scale sine reads 0 dB through the Hann window
+    auto normalise = 4.f / static_cast<float>(fftSize);
+
+    for (auto k = 0; k < numBins; ++k)
+    {
+        auto level = FastMath::gainToDecibels(fftData[static_cast<size_t>(k)] * normalise, minDecibels);
+        auto& smoothed = levels[static_cast<size_t>(k)];
+        smoothed = juce::jmax(level, smoothed - decayPerUpdate);
+    }
+
+    juce::Rectangle<float> area;
+    {
+        const RealtimeGuard::ScopedLock sl(pathLock);
+        area = bounds;
+    }
+
+    if (area.isEmpty())
+        return;
+
+    //one point per pixel column, keeping the loudest bin that falls into it
+    juce::Path newPath;
+    auto binWidth = static_cast<float>(sampleRate.load()) / fftSize;
+    auto lastX = -1;
+    auto columnLevel = minDecibels;
+
+    auto yForLevel = [&area](float level)
+    {
+        return juce::jmap(level, minDecibels, topDecibels, area.getBottom(), area.getY());
+    };
+
+    for (auto k = 1; k < numBins; ++k)
+    {
+        auto frequency = k * binWidth;
+
+        if (frequency < minFrequency)
+            continue;
+
+        if (frequency > maxFrequency)
+            break;
+
+        auto x = juce::roundToInt(area.getX() + area.getWidth() * juce::mapFromLog10(frequency, minFrequency, maxFrequency));
+        columnLevel = juce::jmax(columnLevel, levels[static_cast<size_t>(k)]);
+
+        if (x == lastX)
+            continue;
+
+        if (newPath.isEmpty())
+            newPath.startNewSubPath(static_cast<float>(x), yForLevel(columnLevel));
+        else
+            newPath.lineTo(static_cast<float>(x), yForLevel(columnLevel));
+
+        lastX = x;
+        columnLevel = minDecibels;
+    }
+
+    {
+        const RealtimeGuard::ScopedLock sl(pathLock);
+        path.swapWithPath(newPath);
+    }
+
+    ++generation;
+}
+
+//==============================================================================
+AnalyzerThread::AnalyzerThread() : juce::Thread("Spectrum analyzer")
+{
+    startThread();
+}
+
+AnalyzerThread::~AnalyzerThread()
+{
+    stopThread(1000);
+}
+
+void AnalyzerThread::addSource(SpectrumSource* source)
+{
+    const RealtimeGuard::ScopedLock sl(sourceLock);
+    sources.addIfNotAlreadyThere(source);
+}
+
+void AnalyzerThread::removeSource(SpectrumSource* source)
+{
+    //waits for an update in progress, so the source can be deleted right after
+    const RealtimeGuard::ScopedLock sl(sourceLock);
+    sources.removeFirstMatchingValue(source);
+}
+
+void AnalyzerThread::run()
+{
+    while (! threadShouldExit())
+    {
+        {
+            const RealtimeGuard::ScopedLock sl(sourceLock);
+
+            for (auto* source : sources)
+                source->update();
+        }
+
+        wait(updateIntervalMs);
+    }
+}
+
+//==============================================================================
+SpectrumAnalyzer::SpectrumAnalyzer(SimpleMbCompAudioProcessor& p)
+    : processor(p),
+      preSource(p.getPreAnalyzerFifo()),
+      postSource(p.getPostAnalyzerFifo())
+{
+    setOpaque(true);
+
+    processor.getPreAnalyzerFifo().setEnabled(true);
+    processor.getPostAnalyzerFifo().setEnabled(true);
+
+    analyzerThread->addSource(&preSource);
+    analyzerThread->addSource(&postSource);
+
+    startTimerHz(30);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stopTimer();
+
+    analyzerThread->removeSource(&preSource);
+    analyzerThread->removeSource(&postSource);
+
+    processor.getPreAnalyzerFifo().setEnabled(false);
+    processor.getPostAnalyzerFifo().setEnabled(false);
+}
+
+juce::Rectangle<float> SpectrumAnalyzer::getPlotArea() const
+{
+    return getLocalBounds().toFloat().reduced(24.f, 12.f);
+}
+
+float SpectrumAnalyzer::getXForFrequency(float frequency) const
+{
+    auto area = getPlotArea();
+    return area.getX() + area.getWidth() * juce::mapFromLog10(frequency, minFrequency, maxFrequency);
+}
+
+void SpectrumAnalyzer::resized()
+{
+    preSource.setBounds(getPlotArea());
+    postSource.setBounds(getPlotArea());
+    drawGrid();
+}
+
+void SpectrumAnalyzer::drawGrid()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+        return;
+
+    grid = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+    juce::Graphics g(grid);
+
+    g.fillAll(juce::Colours::black);
+
+    auto area = getPlotArea();
+    g.setFont(10.f);
+
+    for (auto frequency : { 20.f, 50.f, 100.f, 200.f, 500.f, 1000.f, 2000.f, 5000.f, 10000.f, 20000.f })
+    {
+        auto x = getXForFrequency(frequency);
+        g.setColour(juce::Colours::dimgrey.withAlpha(0.5f));
+        g.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+
+        auto text = frequency >= 1000.f ? juce::String(frequency / 1000.f) + "k" : juce::String(frequency);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(text, juce::Rectangle<float>(x - 20.f, area.getBottom(), 40.f, 12.f), juce::Justification::centred);
+    }
+
+    for (auto level = -72.f; level <= 0.f; level += 12.f)
+    {
+        auto y = juce::jmap(level, -72.f, topDecibels, area.getBottom(), area.getY());
+        g.setColour(juce::Colours::dimgrey.withAlpha(0.5f));
+        g.drawHorizontalLine(juce::roundToInt(y), area.getX(), area.getRight());
+
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(juce::String(juce::roundToInt(level)), juce::Rectangle<float>(0.f, y - 6.f, 22.f, 12.f), juce::Justification::centredRight);
+    }
+}
+
+void SpectrumAnalyzer::paint(juce::Graphics& g)
+{
+    g.drawImageAt(grid, 0, 0);
+
+    auto area = getPlotArea();
+    g.reduceClipRegion(area.toNearestInt());
+
+    auto pre = preSource.getPath();
+    g.setColour(juce::Colours::lightgrey.withAlpha(0.35f));
+    g.strokePath(pre, juce::PathStrokeType(1.f));
+
+    auto post = postSource.getPath();
+    g.setColour(juce::Colours::skyblue);
+    g.strokePath(post, juce::PathStrokeType(1.5f));
+
+    g.setColour(juce::Colours::orange);
+    for (auto frequency : lastCrossovers)
+        g.drawVerticalLine(juce::roundToInt(getXForFrequency(frequency)), area.getY(), area.getBottom());
+}
+
+void SpectrumAnalyzer::timerCallback()
+{
+    auto sampleRate = processor.getSampleRate();
+    if (sampleRate > 0)
+    {
+        preSource.setSampleRate(sampleRate);
+        postSource.setSampleRate(sampleRate);
+    }
+
+    std::array<float, Params::NumCrossovers> crossovers;
+    for (size_t j = 0; j < Params::NumCrossovers; ++j)
+    {
+        //the parameter rather than the value tree, which lags behind a preset change
+        auto* param = processor.apvts.getParameter(Params::getName(Params::crossoverFreq(j)));
+        crossovers[j] = param->convertFrom0to1(param->getValue());
+    }
+
+    auto preGeneration = preSource.getGeneration();
+    auto postGeneration = postSource.getGeneration();
+
+    if (preGeneration != lastPreGeneration || postGeneration != lastPostGeneration || crossovers != lastCrossovers)
+    {
+        lastPreGeneration = preGeneration;
+        lastPostGeneration = postGeneration;
+        lastCrossovers = crossovers;
+        repaint();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalyzerFifo.h"
+#include "Params.h"
+#include "RealtimeGuard.h"
+
+class SimpleMbCompAudioProcessor;
+
+/*
+    Turns the samples of one AnalyzerFifo into a spectrum path. The FFT and the path
+    building run on the AnalyzerThread; the message thread only copies the finished path.
+*/
+class SpectrumSource
+{
+public:
+    explicit SpectrumSource(AnalyzerFifo& fifo);
+
+    /** Message thread: where the path is drawn and at what sample rate the audio runs. */
+    void setBounds(juce::Rectangle<float> newBounds);
+    void setSampleRate(double newSampleRate) { sampleRate.store(newSampleRate); }
+
+    /** Message thread: the latest finished path. */
+    juce::Path getPath() const;
+    int getGeneration() const { return generation.load(); }
+
+    /** Analyzer thread: reads new samples and rebuilds the path if any arrived. */
+    void update();
+
+private:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+
+    AnalyzerFifo& fifo;
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann };
+
+    std::vector<float> incoming = std::vector<float>(AnalyzerFifo::capacity);
+    std::vector<float> history = std::vector<float>(fftSize, 0.f);
+    std::vector<float> fftData = std::vector<float>(2 * fftSize, 0.f);
+    std::vector<float> levels = std::vector<float>(numBins, minDecibels);
+
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<int> generation { 0 };
+
+    RealtimeGuard::CheckedCriticalSection pathLock;
+    juce::Rectangle<float> bounds;
+    juce::Path path;
+
+    static constexpr float minDecibels = -72.f;
+    static constexpr float decayPerUpdate = 1.5f;   // dB, about 45 dB/s at 30 updates a second
+};
+
+/*
+    One background thread shared by every open editor, so a session full of instances
+    costs one low-duty thread rather than one per plugin.
+*/
+class AnalyzerThread  : private juce::Thread
+{
+public:
+    AnalyzerThread();
+    ~AnalyzerThread() override;
+
+    void addSource(SpectrumSource* source);
+    void removeSource(SpectrumSource* source);
+
+private:
+    static constexpr int updateIntervalMs = 33;
+
+    RealtimeGuard::CheckedCriticalSection sourceLock;
+    juce::Array<SpectrumSource*> sources;
+
+    void run() override;
+};
+
+/*
+    Pre and post spectra with the crossover frequencies on top. Repaints are capped by
+    the timer and skipped when nothing new arrived.
+*/
+class SpectrumAnalyzer  : public juce::Component,
+                          private juce::Timer
+{
+public:
+    explicit SpectrumAnalyzer(SimpleMbCompAudioProcessor& p);
+    ~SpectrumAnalyzer() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    SimpleMbCompAudioProcessor& processor;
+    juce::SharedResourcePointer<AnalyzerThread> analyzerThread;
+
+    SpectrumSource preSource, postSource;
+    int lastPreGeneration = -1, lastPostGeneration = -1;
+    std::array<float, Params::NumCrossovers> lastCrossovers {};
+
+    juce::Image grid;
+    juce::Rectangle<float> getPlotArea() const;
+    float getXForFrequency(float frequency) const;
+    void drawGrid();
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};
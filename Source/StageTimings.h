@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    StageTimings.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Params.h"
+
+#ifndef SIMPLEMBCOMP_STAGE_TIMING
+ #define SIMPLEMBCOMP_STAGE_TIMING 0
+#endif
+
+/*
+    High resolution tick counts for each stage of the last processBlock call.
+    Only filled in when SIMPLEMBCOMP_STAGE_TIMING is enabled, e.g. by the benchmark
+    project, which also feeds every block to the processor's BlockProfiler; otherwise
+    the timers compile to nothing.
+*/
+struct StageTimings
+{
+    enum Stage
+    {
+        updateState,
+        inputGain,
+        splitBands,
+        firstBand,
+        summing = firstBand + static_cast<int>(Params::NumBands),
+        outputGain,
+        numStages
+    };
+    
+    static const char* getStageName(int stage)
+    {
+        static const auto names = []
+        {
+            std::array<std::string, numStages> n { "update_state", "input_gain", "split_bands" };
+            
+            for (size_t b = 0; b < Params::NumBands; ++b)
+                n[firstBand + b] = "band_" + Params::getBandName(b).toLowerCase().toStdString();
+            
+            n[summing] = "summing";
+            n[outputGain] = "output_gain";
+            return n;
+        }();
+        
+        return names[static_cast<size_t>(stage)].c_str();
+    }
+    
+    void clear() { ticks.fill(0); }
+    
+    std::array<juce::int64, numStages> ticks {};
+};
+
+class ScopedStageTimer
+{
+public:
+   #if SIMPLEMBCOMP_STAGE_TIMING
+    ScopedStageTimer(StageTimings& t, int s) : timings(t), stage(s), start(juce::Time::getHighResolutionTicks()) {}
+    ~ScopedStageTimer() { timings.ticks[static_cast<size_t>(stage)] += juce::Time::getHighResolutionTicks() - start; }
+    
+   private:
+    StageTimings& timings;
+    int stage;
+    juce::int64 start;
+   #else
+    ScopedStageTimer(StageTimings&, int) {}
+   #endif
+    
+    JUCE_DECLARE_NON_COPYABLE(ScopedStageTimer)
+};
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    StateFormat.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Params.h"
+
+/*
+    The plugin state as a flat little-endian record:
+
+        uint32 magic "SMBS", uint16 version, uint16 count
+        count x { uint32 ID hash, float32 value }
+
+    Values are plain (dB, ms, a choice index), not normalised, so they survive range
+    changes. Parameters are matched by the hash of their ID, so a state still loads after
+    parameters are added, removed or reordered; any the state doesn't have go back to their
+    default, as replaceState did with a ValueTree. Eight bytes a parameter, against well
+    over fifty for the ValueTree the plugin used to save, which read() leaves to the caller.
+*/
+namespace StateFormat
+{
+constexpr juce::uint32 magic = 0x534d4253;      // "SMBS" in the file
+constexpr juce::uint16 version = 1;
+constexpr int headerSize = 8;
+
+using Parameters = std::array<juce::RangedAudioParameter*, Params::NumParams>;
+
+/** Appends the state of every parameter to destData. */
+inline void write(juce::MemoryBlock& destData, const Parameters& parameters)
+{
+    juce::MemoryOutputStream out(destData, true);
+    out.writeInt(static_cast<int>(magic));
+    out.writeShort(static_cast<short>(version));
+    out.writeShort(static_cast<short>(Params::NumParams));
+
+    for (size_t i = 0; i < Params::NumParams; ++i)
+    {
+        auto* param = parameters[i];
+        out.writeInt(static_cast<int>(Params::getIdHash(i)));
+        out.writeFloat(param->convertFrom0to1(param->getValue()));
+    }
+}
+
+inline bool isBinaryState(const void* data, int sizeInBytes)
+{
+    return sizeInBytes >= headerSize && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+/** Sets every parameter from a binary state and notifies the host. Returns false, and
+    changes nothing, if the data isn't a state this version can read. */
+inline bool read(const void* data, int sizeInBytes, const Parameters& parameters)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+    in.readInt();
+    auto stateVersion = static_cast<juce::uint16>(in.readShort());
+    auto count = static_cast<juce::uint16>(in.readShort());
+
+    //versions after this one may only append after the entries, so they read too
+    if (stateVersion == 0 || sizeInBytes < headerSize + count * 8)
+    {
+        jassertfalse;
+        return false;
+    }
+
+    std::array<bool, Params::NumParams> found {};
+
+    for (size_t k = 0; k < count; ++k)
+    {
+        auto idHash = static_cast<juce::uint32>(in.readInt());
+        auto value = in.readFloat();
+        auto index = Params::findIndex(idHash, k);
+
+        if (index < Params::NumParams)
+        {
+            auto* param = parameters[index];
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+            found[index] = true;
+        }
+    }
+
+    for (size_t i = 0; i < Params::NumParams; ++i)
+    {
+        if (! found[i])
+            parameters[i]->setValueNotifyingHost(parameters[i]->getDefaultValue());
+    }
+
+    return true;
+}
+}
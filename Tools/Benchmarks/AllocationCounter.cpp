@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+    Replaces the global operator new/delete for the benchmark executable so the
+    suites can count heap allocations made while a block is processed.
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/RealtimeGuard.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<juce::int64> allocationCount { 0 };
+
+void* countedAllocation(std::size_t size)
+{
+    ++allocationCount;
+    RealtimeGuard::checkAllocation();
+    
+    if (auto* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    
+    throw std::bad_alloc();
+}
+
+//freeing can take the allocator's lock just like allocating, as in RealtimeGuard.cpp
+void checkedFree(void* p) noexcept
+{
+    if (p != nullptr)
+        RealtimeGuard::checkAllocation();
+    
+    std::free(p);
+}
+}
+
+juce::int64 Benchmarks::getAllocationCount()
+{
+    return allocationCount.load();
+}
+
+void* operator new(std::size_t size)                                     { return countedAllocation(size); }
+void* operator new[](std::size_t size)                                   { return countedAllocation(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept     { ++allocationCount; RealtimeGuard::checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept   { ++allocationCount; RealtimeGuard::checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void operator delete(void* p) noexcept                                   { checkedFree(p); }
+void operator delete[](void* p) noexcept                                 { checkedFree(p); }
+void operator delete(void* p, std::size_t) noexcept                      { checkedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept                    { checkedFree(p); }
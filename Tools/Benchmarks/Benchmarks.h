@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    Benchmarks.h
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <ostream>
+
+namespace Benchmarks
+{
+inline double ticksToNanoseconds(juce::int64 ticks)
+{
+    return 1.0e9 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
+template <typename SampleType>
+void fillWithNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+{
+    for (auto ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        auto* data = buffer.getWritePointer(ch);
+        
+        for (auto i = 0; i < buffer.getNumSamples(); ++i)
+            data[i] = static_cast<SampleType>(random.nextFloat() * 2.f - 1.f);
+    }
+}
+
+/** Number of global operator new calls made so far by the whole process. */
+juce::int64 getAllocationCount();
+
+/** Each suite writes CSV rows (with a header line) to the given stream. */
+void runCompressorBenchmark(std::ostream& out);
+
+/** Also checks that the bands of every crossover order sum to an allpass; returns false,
+    with the reason on std::cerr, if they don't. */
+bool runCrossoverBenchmark(std::ostream& out);
+
+/** Also checks the accuracy FastMath.h documents; returns false, with the reason on
+    std::cerr, if it doesn't hold. */
+bool runFastMathBenchmark(std::ostream& out);
+void runProcessBlockBenchmark(std::ostream& out);
+void runInstantiationBenchmark(std::ostream& out);
+}
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    CompressorBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/CompressorEngine.h"
+
+namespace
+{
+/** The band compressor the plugin used before CompressorEngine, kept as the reference. */
+struct ReferenceCompressor
+{
+    juce::dsp::Compressor<float> compressor;
+
+    void prepare(const juce::dsp::ProcessSpec& spec, float threshold, float ratio, float attack, float release)
+    {
+        compressor.prepare(spec);
+        compressor.setThreshold(threshold);
+        compressor.setRatio(ratio);
+        compressor.setAttack(attack);
+        compressor.setRelease(release);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        auto block = juce::dsp::AudioBlock<float>(buffer);
+        auto context = juce::dsp::ProcessContextReplacing<float>(block);
+        compressor.process(context);
+    }
+};
+
+struct EngineSettings
+{
+    DetectionMode detection;
+    LevelDetector level;
+    float kneeDb;
+};
+
+const char* getName(DetectionMode mode)
+{
+    switch (mode)
+    {
+        case DetectionMode::unlinked: return "unlinked";
+        case DetectionMode::linked:   return "linked";
+        case DetectionMode::midSide:  return "mid_side";
+    }
+
+    return "";
+}
+
+constexpr float threshold = -12.f, ratio = 4.f, attack = 5.f, release = 100.f;
+
+/** Noise that alternates between loud and quiet every quarter second, so the gain
+    computer spends time both under and over the threshold. */
+juce::AudioBuffer<float> makeBurstNoise(juce::Random& random, int numChannels, int numSamples, double sampleRate)
+{
+    juce::AudioBuffer<float> input(numChannels, numSamples);
+    Benchmarks::fillWithNoise(input, random);
+
+    auto burstLength = static_cast<int>(sampleRate / 4);
+
+    for (auto start = burstLength; start < numSamples; start += 2 * burstLength)
+        for (auto ch = 0; ch < numChannels; ++ch)
+            input.applyGain(ch, start, juce::jmin(burstLength, numSamples - start), 0.05f);
+
+    return input;
+}
+
+template <typename Compressor>
+double timeCompressor(Compressor& compressor, const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int blockSize)
+{
+    juce::int64 ticks = 0;
+    output.makeCopyOf(input, true);
+
+    for (auto start = 0; start + blockSize <= output.getNumSamples(); start += blockSize)
+    {
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), output.getNumChannels(), start, blockSize);
+
+        auto t0 = juce::Time::getHighResolutionTicks();
+        compressor.process(block);
+        ticks += juce::Time::getHighResolutionTicks() - t0;
+    }
+
+    return Benchmarks::ticksToNanoseconds(ticks);
+}
+}
+
+void Benchmarks::runCompressorBenchmark(std::ostream& out)
+{
+    constexpr int blockSize = 512;
+
+    //max_abs_diff is only filled in where the engine is set up like the reference. The
+    //envelope is a recursion from one sample to the next, so a mono engine can't go much
+    //faster than the reference; the target is speedup >= 1 in mono and >= 1.2 in stereo
+    out << "suite,sample_rate,channels,detection,level,knee_db,reference_ns_per_sample,engine_ns_per_sample,speedup,max_abs_diff\n";
+
+    const EngineSettings settings[]
+    {
+        { DetectionMode::unlinked, LevelDetector::peak, 0.f },
+        { DetectionMode::linked,   LevelDetector::peak, 0.f },
+        { DetectionMode::midSide,  LevelDetector::peak, 0.f },
+        { DetectionMode::unlinked, LevelDetector::rms,  0.f },
+        { DetectionMode::linked,   LevelDetector::peak, 6.f },
+        { DetectionMode::midSide,  LevelDetector::rms,  6.f }
+    };
+
+    juce::Random random(1234);
+
+    for (auto sampleRate : { 44100.0, 96000.0 })
+    {
+        for (auto numChannels : { 1, 2 })
+        {
+            auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+            auto channelSamples = static_cast<double>(numSamples) * numChannels;
+            auto input = makeBurstNoise(random, numChannels, numSamples, sampleRate);
+
+            juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+
+            ReferenceCompressor reference;
+            reference.prepare(spec, threshold, ratio, attack, release);
+
+            juce::AudioBuffer<float> referenceOutput, engineOutput;
+            auto referenceNs = timeCompressor(reference, input, referenceOutput, blockSize);
+
+            for (const auto& s : settings)
+            {
+                //configured before prepare, so the threshold starts where the reference's does
+                CompressorEngine<float> engine;
+                engine.setThreshold(threshold);
+                engine.setRatio(ratio);
+                engine.setAttack(attack);
+                engine.setRelease(release);
+                engine.setKnee(s.kneeDb);
+                engine.setDetectionMode(s.detection);
+                engine.setLevelDetector(s.level);
+                engine.prepare(spec, 0);
+
+                auto engineNs = timeCompressor(engine, input, engineOutput, blockSize);
+
+                out << "compressor," << sampleRate << ',' << numChannels << ',' << getName(s.detection) << ','
+                    << (s.level == LevelDetector::peak ? "peak" : "rms") << ',' << s.kneeDb << ','
+                    << referenceNs / channelSamples << ',' << engineNs / channelSamples << ',' << referenceNs / engineNs << ',';
+
+                auto matchesReference = s.level == LevelDetector::peak && s.kneeDb == 0.f
+                                     && (s.detection == DetectionMode::unlinked || numChannels == 1);
+
+                if (matchesReference)
+                {
+                    auto maxDiff = 0.f;
+                    for (auto ch = 0; ch < numChannels; ++ch)
+                        for (auto i = 0; i < numSamples; ++i)
+                            maxDiff = juce::jmax(maxDiff, std::abs(referenceOutput.getSample(ch, i) - engineOutput.getSample(ch, i)));
+
+                    out << maxDiff;
+                }
+
+                out << '\n';
+            }
+        }
+    }
+}
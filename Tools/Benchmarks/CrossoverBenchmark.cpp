@@ -0,0 +1,541 @@
+/*
+  ==============================================================================
+
+    CrossoverBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/CrossoverEngine.h"
+#include "../../Source/LinearPhaseCrossover.h"
+#include <iostream>
+
+namespace
+{
+using ThreeBandEngine = CrossoverEngine<3>;
+
+/** The filter layout the plugin used before CrossoverEngine, kept as the reference. */
+struct ReferenceCrossover
+{
+    using Filter = juce::dsp::LinkwitzRileyFilter<float>;
+    //     fc0      fc1
+    Filter LP1,     AP2,
+           HP1,     LP2,
+                    HP2;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec, float lowMid, float midHigh)
+    {
+        LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+        HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        AP2.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+        LP2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+        HP2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        
+        for (auto* f : { &LP1, &HP1, &AP2, &LP2, &HP2 })
+            f->prepare(spec);
+        
+        LP1.setCutoffFrequency(lowMid);
+        HP1.setCutoffFrequency(lowMid);
+        AP2.setCutoffFrequency(midHigh);
+        LP2.setCutoffFrequency(midHigh);
+        HP2.setCutoffFrequency(midHigh);
+    }
+    
+    void process(const juce::AudioBuffer<float>& input, ThreeBandEngine::BandBuffers& bands)
+    {
+        for (auto ch = 0; ch < input.getNumChannels(); ++ch)
+        {
+            auto* x = input.getReadPointer(ch);
+            auto* low = bands[0].getWritePointer(ch);
+            auto* mid = bands[1].getWritePointer(ch);
+            auto* high = bands[2].getWritePointer(ch);
+            
+            for (auto i = 0; i < input.getNumSamples(); ++i)
+            {
+                low[i] = AP2.processSample(ch, LP1.processSample(ch, x[i]));
+                
+                auto hp = HP1.processSample(ch, x[i]);
+                mid[i] = LP2.processSample(ch, hp);
+                high[i] = HP2.processSample(ch, hp);
+            }
+        }
+        
+        for (auto* f : { &LP1, &HP1, &AP2, &LP2, &HP2 })
+            f->snapToZero();
+    }
+};
+
+template <typename Crossover, typename SampleType, typename Bands>
+double timeCrossover(Crossover& crossover,
+                     const juce::AudioBuffer<SampleType>& input,
+                     Bands& bands,
+                     int blockSize)
+{
+    juce::int64 ticks = 0;
+    
+    for (auto start = 0; start + blockSize <= input.getNumSamples(); start += blockSize)
+    {
+        juce::AudioBuffer<SampleType> block(const_cast<SampleType* const*>(input.getArrayOfReadPointers()),
+                                            input.getNumChannels(), start, blockSize);
+        
+        auto t0 = juce::Time::getHighResolutionTicks();
+        crossover.process(block, bands);
+        ticks += juce::Time::getHighResolutionTicks() - t0;
+    }
+    
+    return Benchmarks::ticksToNanoseconds(ticks);
+}
+
+template <size_t NumBands>
+void timeBandCount(std::ostream& out, const juce::AudioBuffer<float>& input, double sampleRate, int blockSize)
+{
+    juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(input.getNumChannels()) };
+    
+    CrossoverEngine<NumBands> engine;
+    engine.prepare(spec);
+    
+    typename CrossoverEngine<NumBands>::BandBuffers bands;
+    for (auto& b : bands)
+        b.setSize(input.getNumChannels(), blockSize);
+    
+    auto ns = timeCrossover(engine, input, bands, blockSize);
+    auto channelSamples = static_cast<double>(input.getNumSamples()) * input.getNumChannels();
+    
+    out << "crossover_bands," << sampleRate << ',' << input.getNumChannels() << ',' << NumBands << ','
+        << ns / channelSamples << ',' << ns / (channelSamples * NumBands) << '\n';
+}
+
+/** Largest difference between the summed bands and the input delayed by the reported latency. */
+float getReconstructionError(LinearPhaseCrossover<3>& crossover, const juce::AudioBuffer<float>& input, int blockSize)
+{
+    auto latency = crossover.getLatencySamples();
+    auto numChannels = input.getNumChannels();
+    auto maxDiff = 0.f;
+    
+    LinearPhaseCrossover<3>::BandBuffers bands;
+    for (auto& b : bands)
+        b.setSize(numChannels, blockSize);
+    
+    for (auto start = 0; start + blockSize <= input.getNumSamples(); start += blockSize)
+    {
+        juce::AudioBuffer<float> block(const_cast<float* const*>(input.getArrayOfReadPointers()), numChannels, start, blockSize);
+        crossover.process(block, bands);
+        
+        for (auto ch = 0; ch < numChannels; ++ch)
+        {
+            for (auto i = 0; i < blockSize; ++i)
+            {
+                auto delayedIndex = start + i - latency;
+                auto expected = delayedIndex >= 0 ? input.getSample(ch, delayedIndex) : 0.f;
+                
+                auto sum = 0.f;
+                for (auto& b : bands)
+                    sum += b.getSample(ch, i);
+                
+                maxDiff = juce::jmax(maxDiff, std::abs(sum - expected));
+            }
+        }
+    }
+    
+    return maxDiff;
+}
+
+template <typename SampleType>
+double timeThreeBandEngine(const juce::AudioBuffer<float>& input, double sampleRate, int blockSize)
+{
+    juce::AudioBuffer<SampleType> converted;
+    converted.makeCopyOf(input);
+    
+    juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(input.getNumChannels()) };
+    
+    CrossoverEngine<3, SampleType> engine;
+    engine.prepare(spec);
+    
+    typename CrossoverEngine<3, SampleType>::BandBuffers bands;
+    for (auto& b : bands)
+        b.setSize(input.getNumChannels(), blockSize);
+    
+    return timeCrossover(engine, converted, bands, blockSize);
+}
+
+/*
+    The same two stage TPT lowpass the engine runs for its lowest band, in long double.
+    Low cutoffs at high sample rates are where the tiny g of the integrators loses
+    precision first, so this is what the float and double engines are measured against.
+*/
+struct PrecisionReference
+{
+    long double g = 0, h = 0, R2 = std::sqrt(2.0L);
+    std::array<long double, 4> s {};
+    
+    PrecisionReference(double sampleRate, float cutoff)
+    {
+        g = std::tan(juce::MathConstants<long double>::pi * cutoff / sampleRate);
+        h = 1.0L / (1.0L + R2 * g + g * g);
+    }
+    
+    long double processSample(long double x)
+    {
+        for (size_t stage = 0; stage < 4; stage += 2)
+        {
+            auto& s1 = s[stage];
+            auto& s2 = s[stage + 1];
+            
+            auto yH = (x - (R2 + g) * s1 - s2) * h;
+            auto yB = g * yH + s1;
+            s1 = g * yH + yB;
+            
+            auto yL = g * yB + s2;
+            s2 = g * yB + yL;
+            
+            x = yL;
+        }
+        
+        return x;
+    }
+};
+
+/** RMS difference between the engine's low band and the long double reference, in dB below the band's level. */
+template <typename SampleType>
+double getLowBandError(const juce::AudioBuffer<float>& input, double sampleRate, float cutoff, int blockSize)
+{
+    juce::AudioBuffer<SampleType> converted;
+    converted.makeCopyOf(input);
+    
+    juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), 1 };
+    
+    CrossoverEngine<2, SampleType> engine;
+    //set first, so the engine starts at the cutoff instead of gliding to it
+    engine.setCrossoverFrequency(0, cutoff);
+    engine.prepare(spec);
+    
+    typename CrossoverEngine<2, SampleType>::BandBuffers bands;
+    for (auto& b : bands)
+        b.setSize(1, blockSize);
+    
+    PrecisionReference reference(sampleRate, cutoff);
+    long double errorSquares = 0, signalSquares = 0;
+    
+    for (auto start = 0; start + blockSize <= input.getNumSamples(); start += blockSize)
+    {
+        juce::AudioBuffer<SampleType> block(converted.getArrayOfWritePointers(), 1, start, blockSize);
+        engine.process(block, bands);
+        
+        for (auto i = 0; i < blockSize; ++i)
+        {
+            auto expected = reference.processSample(input.getSample(0, start + i));
+            auto error = static_cast<long double>(bands[0].getSample(0, i)) - expected;
+            
+            errorSquares += error * error;
+            signalSquares += expected * expected;
+        }
+    }
+    
+    return juce::Decibels::gainToDecibels(static_cast<double>(std::sqrt(errorSquares / signalSquares)), -400.0);
+}
+
+const char* getOrderName(CrossoverOrder order)
+{
+    return order == CrossoverOrder::lr2 ? "lr2" : (order == CrossoverOrder::lr4 ? "lr4" : "lr8");
+}
+
+/** The most getAllpassDeviation may report before the run fails. Float rounding gives
+    under 1e-5 dB on every order and grows with the number of sections; a missing or
+    mismatched compensation allpass puts dBs of ripple around the crossovers. */
+float getMaxAllpassDeviationDb(CrossoverOrder order)
+{
+    return order == CrossoverOrder::lr2 ? 0.001f : (order == CrossoverOrder::lr4 ? 0.002f : 0.004f);
+}
+
+/** How far the magnitude response of the summed bands strays from 0 dB, in dB. Every
+    order must sum to an allpass, so anything above rounding means a broken compensation. */
+float getAllpassDeviation(CrossoverOrder order, double sampleRate, int blockSize, float lowMid, float midHigh)
+{
+    constexpr int fftOrder = 15;
+    constexpr int fftSize = 1 << fftOrder;
+    
+    juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), 1 };
+    
+    ThreeBandEngine engine;
+    engine.setOrder(order);
+    engine.setCrossoverFrequency(0, lowMid);
+    engine.setCrossoverFrequency(1, midHigh);
+    engine.prepare(spec);
+    
+    ThreeBandEngine::BandBuffers bands;
+    for (auto& b : bands)
+        b.setSize(1, blockSize);
+    
+    juce::AudioBuffer<float> impulse(1, fftSize);
+    impulse.clear();
+    impulse.setSample(0, 0, 1.f);
+    
+    std::vector<float> response(2 * fftSize, 0.f);
+    
+    for (auto start = 0; start + blockSize <= fftSize; start += blockSize)
+    {
+        juce::AudioBuffer<float> block(impulse.getArrayOfWritePointers(), 1, start, blockSize);
+        engine.process(block, bands);
+        
+        for (auto& b : bands)
+            juce::FloatVectorOperations::add(response.data() + start, b.getReadPointer(0), blockSize);
+    }
+    
+    juce::dsp::FFT fft(fftOrder);
+    fft.performFrequencyOnlyForwardTransform(response.data());
+    
+    auto maxDeviation = 0.f;
+    for (auto k = 1; k < fftSize / 2; ++k)
+        maxDeviation = juce::jmax(maxDeviation, std::abs(juce::Decibels::gainToDecibels(response[static_cast<size_t>(k)], -200.f)));
+    
+    return maxDeviation;
+}
+
+/** Like timeCrossover, but with both cutoffs moved by a slow sine before every block, as automation or the morph does. */
+double timeModulatedCrossover(ThreeBandEngine& engine, const juce::AudioBuffer<float>& input, ThreeBandEngine::BandBuffers& bands,
+                              double sampleRate, int blockSize, float lowMid, float midHigh)
+{
+    constexpr double sweepHz = 0.5, sweepOctaves = 1.0;
+    juce::int64 ticks = 0;
+    
+    for (auto start = 0; start + blockSize <= input.getNumSamples(); start += blockSize)
+    {
+        juce::AudioBuffer<float> block(const_cast<float* const*>(input.getArrayOfReadPointers()), input.getNumChannels(), start, blockSize);
+        auto scale = static_cast<float>(std::exp2(sweepOctaves * std::sin(juce::MathConstants<double>::twoPi * sweepHz * start / sampleRate)));
+        
+        auto t0 = juce::Time::getHighResolutionTicks();
+        engine.setCrossoverFrequency(0, lowMid * scale);
+        engine.setCrossoverFrequency(1, midHigh * scale);
+        engine.process(block, bands);
+        ticks += juce::Time::getHighResolutionTicks() - t0;
+    }
+    
+    return Benchmarks::ticksToNanoseconds(ticks);
+}
+
+template <size_t... BandCounts>
+void runBandCountScaling(std::ostream& out, const juce::AudioBuffer<float>& input, double sampleRate, int blockSize,
+                         std::index_sequence<BandCounts...>)
+{
+    (timeBandCount<BandCounts + 2>(out, input, sampleRate, blockSize), ...);
+}
+}
+
+bool Benchmarks::runCrossoverBenchmark(std::ostream& out)
+{
+    constexpr int blockSize = 512;
+    constexpr float lowMid = 400.f, midHigh = 2000.f;
+    
+    out << "suite,sample_rate,channels,reference_ns_per_sample,simd_ns_per_sample,speedup,max_abs_diff\n";
+    
+    juce::Random random(1234);
+    
+    for (auto sampleRate : { 44100.0, 96000.0, 192000.0 })
+    {
+        for (auto numChannels : { 1, 2, 6 })
+        {
+            auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+            
+            juce::AudioBuffer<float> input(numChannels, numSamples);
+            fillWithNoise(input, random);
+            
+            juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+            
+            ReferenceCrossover reference;
+            reference.prepare(spec, lowMid, midHigh);
+            
+            ThreeBandEngine engine;
+            engine.setCrossoverFrequency(0, lowMid);
+            engine.setCrossoverFrequency(1, midHigh);
+            engine.prepare(spec);
+            
+            ThreeBandEngine::BandBuffers referenceBands, engineBands;
+            for (auto& b : referenceBands)
+                b.setSize(numChannels, blockSize);
+            for (auto& b : engineBands)
+                b.setSize(numChannels, blockSize);
+            
+            //warm up, then compare one block for correctness before timing
+            juce::AudioBuffer<float> firstBlock(numChannels, blockSize);
+            for (auto ch = 0; ch < numChannels; ++ch)
+                firstBlock.copyFrom(ch, 0, input, ch, 0, blockSize);
+            
+            reference.process(firstBlock, referenceBands);
+            engine.process(firstBlock, engineBands);
+            
+            auto maxDiff = 0.f;
+            for (size_t b = 0; b < referenceBands.size(); ++b)
+                for (auto ch = 0; ch < numChannels; ++ch)
+                    for (auto i = 0; i < blockSize; ++i)
+                        maxDiff = juce::jmax(maxDiff, std::abs(referenceBands[b].getSample(ch, i) - engineBands[b].getSample(ch, i)));
+            
+            auto referenceNs = timeCrossover(reference, input, referenceBands, blockSize);
+            auto engineNs = timeCrossover(engine, input, engineBands, blockSize);
+            
+            auto channelSamples = static_cast<double>(numSamples) * numChannels;
+            
+            out << "crossover," << sampleRate << ',' << numChannels << ','
+                << referenceNs / channelSamples << ',' << engineNs / channelSamples << ','
+                << referenceNs / engineNs << ',' << maxDiff << '\n';
+        }
+    }
+    
+    //cost of the generic engine as the band count grows, 2 to 8 bands
+    out << "suite,sample_rate,channels,bands,ns_per_sample,ns_per_band_sample\n";
+    
+    for (auto numChannels : { 1, 2 })
+    {
+        auto sampleRate = 48000.0;
+        auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+        
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        fillWithNoise(input, random);
+        
+        runBandCountScaling(out, input, sampleRate, blockSize, std::make_index_sequence<7>());
+    }
+    
+    //linear phase mode: cost per sample and how exactly the bands sum back to the delayed input
+    out << "suite,sample_rate,channels,latency_samples,ns_per_sample,max_reconstruction_error\n";
+    
+    for (auto sampleRate : { 44100.0, 96000.0, 192000.0 })
+    {
+        for (auto numChannels : { 1, 2 })
+        {
+            auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+            
+            juce::AudioBuffer<float> input(numChannels, numSamples);
+            fillWithNoise(input, random);
+            
+            juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+            
+            LinearPhaseCrossover<3> crossover;
+            crossover.setCrossoverFrequency(0, lowMid);
+            crossover.setCrossoverFrequency(1, midHigh);
+            crossover.prepare(spec);
+            
+            auto maxDiff = getReconstructionError(crossover, input, blockSize);
+            
+            LinearPhaseCrossover<3>::BandBuffers bands;
+            for (auto& b : bands)
+                b.setSize(numChannels, blockSize);
+            
+            auto ns = timeCrossover(crossover, input, bands, blockSize);
+            
+            out << "crossover_linear_phase," << sampleRate << ',' << numChannels << ',' << crossover.getLatencySamples() << ','
+                << ns / (static_cast<double>(numSamples) * numChannels) << ',' << maxDiff << '\n';
+        }
+    }
+    
+    //cutoffs modulated every block against fixed ones; the difference is the glide and the coefficient lookups
+    out << "suite,sample_rate,channels,block_size,static_ns_per_sample,modulated_ns_per_sample,modulation_cost\n";
+    
+    for (auto sampleRate : { 44100.0, 96000.0 })
+    {
+        for (auto modulatedBlockSize : { 16, 64, 512 })
+        {
+            constexpr int numChannels = 2;
+            auto numSamples = static_cast<int>(sampleRate) * 10 / modulatedBlockSize * modulatedBlockSize;
+            
+            juce::AudioBuffer<float> input(numChannels, numSamples);
+            fillWithNoise(input, random);
+            
+            juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(modulatedBlockSize), static_cast<juce::uint32>(numChannels) };
+            
+            ThreeBandEngine engine;
+            engine.setCrossoverFrequency(0, lowMid);
+            engine.setCrossoverFrequency(1, midHigh);
+            engine.prepare(spec);
+            
+            ThreeBandEngine::BandBuffers bands;
+            for (auto& b : bands)
+                b.setSize(numChannels, modulatedBlockSize);
+            
+            auto staticNs = timeCrossover(engine, input, bands, modulatedBlockSize);
+            auto modulatedNs = timeModulatedCrossover(engine, input, bands, sampleRate, modulatedBlockSize, lowMid, midHigh);
+            auto channelSamples = static_cast<double>(numSamples) * numChannels;
+            
+            out << "crossover_modulated," << sampleRate << ',' << numChannels << ',' << modulatedBlockSize << ','
+                << staticNs / channelSamples << ',' << modulatedNs / channelSamples << ',' << modulatedNs / staticNs << '\n';
+        }
+    }
+    
+    //each Linkwitz-Riley order: its cost, and whether the bands still sum to an allpass
+    out << "suite,sample_rate,channels,order,ns_per_sample,max_sum_deviation_db\n";
+    
+    auto passed = true;
+    
+    for (auto sampleRate : { 44100.0, 96000.0 })
+    {
+        for (auto order : { CrossoverOrder::lr2, CrossoverOrder::lr4, CrossoverOrder::lr8 })
+        {
+            auto deviation = getAllpassDeviation(order, sampleRate, blockSize, lowMid, midHigh);
+            
+            if (deviation > getMaxAllpassDeviationDb(order))
+            {
+                std::cerr << "crossover_order " << getOrderName(order) << " at " << sampleRate << " Hz: bands sum "
+                          << deviation << " dB away from an allpass, over " << getMaxAllpassDeviationDb(order) << " dB\n";
+                passed = false;
+            }
+            
+            for (auto numChannels : { 1, 2, 6 })
+            {
+                auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+                
+                juce::AudioBuffer<float> input(numChannels, numSamples);
+                fillWithNoise(input, random);
+                
+                juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+                
+                ThreeBandEngine engine;
+                engine.setOrder(order);
+                engine.setCrossoverFrequency(0, lowMid);
+                engine.setCrossoverFrequency(1, midHigh);
+                engine.prepare(spec);
+                
+                ThreeBandEngine::BandBuffers bands;
+                for (auto& b : bands)
+                    b.setSize(numChannels, blockSize);
+                
+                auto ns = timeCrossover(engine, input, bands, blockSize);
+                
+                out << "crossover_order," << sampleRate << ',' << numChannels << ',' << getOrderName(order) << ','
+                    << ns / (static_cast<double>(numSamples) * numChannels) << ',' << deviation << '\n';
+            }
+        }
+    }
+    
+    //float against double: what the double path costs and what it buys on a low crossover
+    constexpr float lowCutoff = 30.f;
+    
+    out << "suite,sample_rate,channels,float_ns_per_sample,double_ns_per_sample,double_cost,low_cutoff_hz,float_error_db,double_error_db\n";
+    
+    for (auto sampleRate : { 44100.0, 96000.0, 192000.0 })
+    {
+        auto numSamples = static_cast<int>(sampleRate) * 10 / blockSize * blockSize;
+        
+        juce::AudioBuffer<float> mono(1, numSamples);
+        fillWithNoise(mono, random);
+        
+        auto floatError = getLowBandError<float>(mono, sampleRate, lowCutoff, blockSize);
+        auto doubleError = getLowBandError<double>(mono, sampleRate, lowCutoff, blockSize);
+        
+        for (auto numChannels : { 1, 2, 6 })
+        {
+            juce::AudioBuffer<float> input(numChannels, numSamples);
+            fillWithNoise(input, random);
+            
+            auto floatNs = timeThreeBandEngine<float>(input, sampleRate, blockSize);
+            auto doubleNs = timeThreeBandEngine<double>(input, sampleRate, blockSize);
+            auto channelSamples = static_cast<double>(numSamples) * numChannels;
+            
+            out << "crossover_precision," << sampleRate << ',' << numChannels << ','
+                << floatNs / channelSamples << ',' << doubleNs / channelSamples << ',' << doubleNs / floatNs << ','
+                << lowCutoff << ',' << floatError << ',' << doubleError << '\n';
+        }
+    }
+    
+    return passed;
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    FastMathBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/FastMath.h"
+#include <iostream>
+
+namespace
+{
+constexpr double minDb = -140.0, maxDb = 24.0;
+
+//what the meters and the gain computer can live with; FastMath.h documents ~0.0003 dB
+constexpr double maxErrorDb = 0.01;
+
+//the timed sums land here so the optimiser can't drop the work
+volatile double sink = 0.0;
+
+template <typename FloatType>
+const char* getPrecisionName() { return sizeof(FloatType) == sizeof(float) ? "float" : "double"; }
+
+/** Runs f over the whole array a few times. */
+template <typename FloatType, typename Function>
+double timePerValue(const std::vector<FloatType>& input, Function&& f)
+{
+    constexpr int numRuns = 20;
+    auto sum = FloatType(0);
+
+    auto t0 = juce::Time::getHighResolutionTicks();
+
+    for (auto run = 0; run < numRuns; ++run)
+        for (auto v : input)
+            sum += f(v);
+
+    auto ticks = juce::Time::getHighResolutionTicks() - t0;
+    sink = sink + static_cast<double>(sum);
+
+    return Benchmarks::ticksToNanoseconds(ticks) / (static_cast<double>(input.size()) * numRuns);
+}
+
+/** The exact points FastMath.h promises: log2 at powers of two, exp2 at integers. */
+template <typename FloatType>
+bool isExactAtIntegers()
+{
+    for (auto n = -126; n <= 126; ++n)
+    {
+        auto powerOfTwo = std::ldexp(FloatType(1), n);
+
+        if (FastMath::exp2(static_cast<FloatType>(n)) != powerOfTwo || FastMath::log2(powerOfTwo) != static_cast<FloatType>(n))
+            return false;
+    }
+
+    return true;
+}
+
+template <typename FloatType>
+bool runPrecision(std::ostream& out)
+{
+    constexpr size_t numValues = 1 << 18;
+
+    std::vector<FloatType> decibels(numValues), gains(numValues);
+
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        auto db = minDb + (maxDb - minDb) * static_cast<double>(i) / (numValues - 1);
+        decibels[i] = static_cast<FloatType>(db);
+        gains[i] = static_cast<FloatType>(std::pow(10.0, db / 20.0));
+    }
+
+    //errors are against double precision library math, in dB
+    auto toDbError = 0.0, toGainError = 0.0, roundTripError = 0.0;
+
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        auto exactDb = 20.0 * std::log10(static_cast<double>(gains[i]));
+        toDbError = juce::jmax(toDbError, std::abs(static_cast<double>(FastMath::gainToDecibels(gains[i], FloatType(-200))) - exactDb));
+
+        auto gain = static_cast<double>(FastMath::decibelsToGain(decibels[i]));
+        toGainError = juce::jmax(toGainError, std::abs(20.0 * std::log10(gain) - static_cast<double>(decibels[i])));
+
+        auto roundTrip = FastMath::gainToDecibels(FastMath::decibelsToGain(decibels[i]), FloatType(-200));
+        roundTripError = juce::jmax(roundTripError, std::abs(static_cast<double>(roundTrip - decibels[i])));
+    }
+
+    auto exactToDb = timePerValue(gains, [](FloatType g) { return juce::Decibels::gainToDecibels(g, FloatType(-200)); });
+    auto fastToDb = timePerValue(gains, [](FloatType g) { return FastMath::gainToDecibels(g, FloatType(-200)); });
+    auto exactToGain = timePerValue(decibels, [](FloatType db) { return juce::Decibels::decibelsToGain(db, FloatType(-200)); });
+    auto fastToGain = timePerValue(decibels, [](FloatType db) { return FastMath::decibelsToGain(db); });
+
+    auto writeRow = [&out](const char* function, double errorDb, double exactNs, double fastNs)
+    {
+        out << "fast_math," << getPrecisionName<FloatType>() << ',' << function << ',' << errorDb << ','
+            << exactNs << ',' << fastNs << ',' << (fastNs > 0 ? exactNs / fastNs : 0.0) << '\n';
+    };
+
+    writeRow("gain_to_db", toDbError, exactToDb, fastToDb);
+    writeRow("db_to_gain", toGainError, exactToGain, fastToGain);
+    writeRow("round_trip", roundTripError, exactToDb + exactToGain, fastToDb + fastToGain);
+
+    auto passed = true;
+
+    auto check = [&passed](bool condition, const char* what)
+    {
+        if (! condition)
+        {
+            std::cerr << "fast_math " << getPrecisionName<FloatType>() << ": " << what << '\n';
+            passed = false;
+        }
+    };
+
+    check(juce::jmax(toDbError, toGainError, roundTripError) < maxErrorDb, "conversion error over 0.01 dB");
+    check(isExactAtIntegers<FloatType>(), "not exact at powers of two");
+
+    return passed;
+}
+}
+
+bool Benchmarks::runFastMathBenchmark(std::ostream& out)
+{
+    //the double rows time library math in both columns, as every row does with
+    //SIMPLEMBCOMP_EXACT_MATH=1; their errors are only rounding
+    out << "suite,precision,function,max_error_db,exact_ns_per_value,fast_ns_per_value,speedup\n";
+
+    auto floatPassed = runPrecision<float>(out);
+    auto doublePassed = runPrecision<double>(out);
+
+    return floatPassed && doublePassed;
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    InstantiationBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+/** What a template session with a few hundred instances pays before any audio runs. */
+constexpr int numInstances = 200;
+
+/** Every parameter away from its default, so restoring a state changes all of them. */
+void editParameters(SimpleMbCompAudioProcessor& processor)
+{
+    for (auto* param : processor.getParameters())
+        param->setValueNotifyingHost(0.25f);
+}
+
+/** A bank of presets with random settings. */
+void writeBank(const juce::File& file, juce::Random& random)
+{
+    SimpleMbCompAudioProcessor processor;
+    std::vector<PresetBank::Preset> presets(128);
+
+    for (size_t p = 0; p < presets.size(); ++p)
+    {
+        presets[p].name = "Preset " + juce::String(static_cast<int>(p) + 1);
+
+        for (size_t i = 0; i < Params::NumParams; ++i)
+            presets[p].values[i] = processor.apvts.getParameter(Params::getName(i))->convertFrom0to1(random.nextFloat());
+    }
+
+    PresetBank::write(file, presets);
+}
+
+template <typename Function>
+void timeOperation(std::ostream& out, const char* operation, Function&& f)
+{
+    auto allocationsBefore = Benchmarks::getAllocationCount();
+    auto start = juce::Time::getHighResolutionTicks();
+
+    for (auto i = 0; i < numInstances; ++i)
+        f(i);
+
+    auto ticks = juce::Time::getHighResolutionTicks() - start;
+    auto allocations = Benchmarks::getAllocationCount() - allocationsBefore;
+
+    out << "instantiation," << operation << ',' << numInstances << ','
+        << Benchmarks::ticksToNanoseconds(ticks) / 1000.0 / numInstances << ','
+        << static_cast<double>(allocations) / numInstances << '\n';
+}
+}
+
+void Benchmarks::runInstantiationBenchmark(std::ostream& out)
+{
+    out << "suite,operation,instances,us_per_instance,allocs_per_instance\n";
+
+    //the first instance also starts the shared worker pool and builds the static tables
+    juce::MemoryBlock state, legacyState;
+    {
+        SimpleMbCompAudioProcessor processor;
+        editParameters(processor);
+        processor.getStateInformation(state);
+
+        //what sessions saved before the binary format hold
+        juce::MemoryOutputStream legacy(legacyState, false);
+        processor.apvts.copyState().writeToStream(legacy);
+    }
+
+    std::vector<std::unique_ptr<SimpleMbCompAudioProcessor>> processors(numInstances);
+    std::vector<juce::MemoryBlock> states(numInstances);
+
+    timeOperation(out, "construct", [&processors](int i) { processors[static_cast<size_t>(i)] = std::make_unique<SimpleMbCompAudioProcessor>(); });
+    timeOperation(out, "set_state", [&processors, &state](int i) { processors[static_cast<size_t>(i)]->setStateInformation(state.getData(), static_cast<int>(state.getSize())); });
+    timeOperation(out, "set_state_legacy", [&processors, &legacyState](int i) { processors[static_cast<size_t>(i)]->setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize())); });
+    timeOperation(out, "get_state", [&processors, &states](int i) { processors[static_cast<size_t>(i)]->getStateInformation(states[static_cast<size_t>(i)]); });
+
+    juce::Random random(1234);
+    juce::TemporaryFile bankFile(".bank");
+    writeBank(bankFile.getFile(), random);
+
+    timeOperation(out, "load_bank", [&processors, &bankFile](int i) { processors[static_cast<size_t>(i)]->loadPresetBank(bankFile.getFile()); });
+
+    //a switch lands in the next block, so this is the cost of copying a preset out of the
+    //bank (this is the message thread) plus a block with the switch in it. The handover
+    //allocates nothing; any allocations counted come from posting the message that
+    //notifies the listeners afterwards
+    {
+        auto& processor = *processors.front();
+        processor.prepareToPlay(48000.0, 64);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumInputChannels(), 64);
+        juce::MidiBuffer midi;
+        Benchmarks::fillWithNoise(buffer, random);
+
+        timeOperation(out, "switch_program", [&processor, &buffer, &midi](int i)
+        {
+            processor.setCurrentProgram(i % processor.getNumPrograms());
+            processor.processBlock(buffer, midi);
+        });
+
+        processor.releaseResources();
+    }
+
+    timeOperation(out, "destroy", [&processors](int i) { processors[static_cast<size_t>(i)].reset(); });
+}
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <fstream>
+#include <iostream>
+#include "Benchmarks.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    std::ofstream file;
+    if (args.containsOption("--output"))
+        file.open(args.getValueForOption("--output").toStdString());
+    
+    std::ostream& out = file.is_open() ? file : std::cout;
+    
+    auto runAll = ! args.containsOption("--crossover") && ! args.containsOption("--compressor") && ! args.containsOption("--fast-math") && ! args.containsOption("--process-block")
+                && ! args.containsOption("--instantiation");
+    
+    //the suites with a pass/fail check set the exit code
+    auto passed = true;
+    
+    if (runAll || args.containsOption("--crossover"))
+        passed = Benchmarks::runCrossoverBenchmark(out) && passed;
+    
+    if (runAll || args.containsOption("--compressor"))
+        Benchmarks::runCompressorBenchmark(out);
+    
+    if (runAll || args.containsOption("--fast-math"))
+        passed = Benchmarks::runFastMathBenchmark(out) && passed;
+    
+    if (runAll || args.containsOption("--process-block"))
+        Benchmarks::runProcessBlockBenchmark(out);
+    
+    if (runAll || args.containsOption("--instantiation"))
+        Benchmarks::runInstantiationBenchmark(out);
+    
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+    ProcessBlockBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+enum class BandState
+{
+    active,
+    bypassed,
+    soloed,
+    muted
+};
+
+const char* getName(BandState state)
+{
+    switch (state)
+    {
+        case BandState::active:   return "active";
+        case BandState::bypassed: return "bypassed";
+        case BandState::soloed:   return "soloed";
+        case BandState::muted:    return "muted";
+    }
+    
+    return "";
+}
+
+void setParameter(SimpleMbCompAudioProcessor& processor, size_t index, bool value)
+{
+    auto* param = processor.apvts.getParameter(Params::getName(index));
+    param->setValueNotifyingHost(value ? 1.f : 0.f);
+}
+
+/** bypassed: every band bypassed, soloed: lowest band soloed, muted: lowest and highest band muted. */
+void setBandState(SimpleMbCompAudioProcessor& processor, BandState state)
+{
+    using namespace Params;
+    
+    for (size_t band = 0; band < NumBands; ++band)
+    {
+        auto isOuterBand = band == 0 || band == NumBands - 1;
+        
+        setParameter(processor, bandParam(BandParam::Bypassed, band), state == BandState::bypassed);
+        setParameter(processor, bandParam(BandParam::Solo, band), state == BandState::soloed && band == 0);
+        setParameter(processor, bandParam(BandParam::Mute, band), state == BandState::muted && isOuterBand);
+    }
+}
+
+/** Moves the crossovers, every threshold and both gains a little, like host automation would. */
+void automate(SimpleMbCompAudioProcessor& processor, int block)
+{
+    using namespace Params;
+    
+    auto value = 0.5f + 0.25f * std::sin(0.05f * static_cast<float>(block));
+    auto set = [&processor](size_t index, float v) { processor.apvts.getParameter(getName(index))->setValueNotifyingHost(v); };
+    
+    for (size_t j = 0; j < NumCrossovers; ++j)
+        set(crossoverFreq(j), value);
+    
+    for (size_t band = 0; band < NumBands; ++band)
+        set(bandParam(BandParam::Threshold, band), value);
+    
+    set(GainIn, value);
+    set(GainOut, 1.f - value);
+}
+
+double percentile(std::vector<juce::int64>& sorted, double p)
+{
+    auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return Benchmarks::ticksToNanoseconds(sorted[index]) / 1000.0;
+}
+
+struct Configuration
+{
+    double sampleRate;
+    juce::AudioChannelSet channels;
+    int blockSize;
+    BandState state;
+    bool silentInput;
+    bool elision;
+    juce::AudioChannelSet sidechain {};     // disabled unless given; keys every band when set
+    bool doublePrecision = false;
+    int hostBlockSize = 0;                  // what processBlock is given; blockSize, the prepared size, unless set
+    bool automated = false;                 // parameters move before every block
+    bool offline = false;                   // setNonRealtime, which spreads every block over the worker pool
+    bool morphing = false;                  // Morph sweeps between two snapshots before every block
+    SimpleMbCompAudioProcessor::LiveParallelism parallelism = SimpleMbCompAudioProcessor::LiveParallelism::bySize;
+};
+
+/** realtime_pool and realtime_serial force live blocks on or off the pool; realtime_pool_refused
+    means the workers didn't get realtime priority, so those blocks ran serially after all. */
+const char* getModeName(const Configuration& config, const SimpleMbCompAudioProcessor& processor)
+{
+    using LiveParallelism = SimpleMbCompAudioProcessor::LiveParallelism;
+    
+    if (config.offline)
+        return "offline";
+    
+    switch (config.parallelism)
+    {
+        case LiveParallelism::bySize: return "realtime";
+        case LiveParallelism::always: return processor.isUsingWorkerPool() ? "realtime_pool" : "realtime_pool_refused";
+        case LiveParallelism::never:  return "realtime_serial";
+    }
+    
+    return "";
+}
+
+template <typename SampleType>
+void runConfiguration(std::ostream& out, juce::Random& random, const Configuration& config)
+{
+    SimpleMbCompAudioProcessor processor;
+    processor.setComputeElisionEnabled(config.elision);
+    processor.setNonRealtime(config.offline);
+    processor.setLiveParallelism(config.parallelism);
+    processor.setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                            : juce::AudioProcessor::singlePrecision);
+    
+    auto layout = processor.getBusesLayout();
+    layout.inputBuses.getReference(0) = config.channels;
+    layout.inputBuses.getReference(1) = config.sidechain;
+    layout.outputBuses.getReference(0) = config.channels;
+    processor.setBusesLayout(layout);
+    
+    //the sidechain channels follow the main ones in the buffer, as a host passes them
+    auto numMainChannels = config.channels.size();
+    auto numKeyChannels = config.sidechain.size();
+    auto numChannels = numMainChannels + numKeyChannels;
+    
+    setBandState(processor, config.state);
+    
+    for (size_t band = 0; band < Params::NumBands; ++band)
+        setParameter(processor, Params::bandParam(Params::BandParam::Sidechain, band), numKeyChannels > 0);
+    
+    if (config.morphing)
+    {
+        //A is the defaults, B moves every morphable setting
+        processor.storeMorphSnapshot(PresetMorph::slotA);
+        automate(processor, 30);
+        
+        for (size_t band = 0; band < Params::NumBands; ++band)
+        {
+            setParameter(processor, Params::bandParam(Params::BandParam::Attack, band), true);
+            setParameter(processor, Params::bandParam(Params::BandParam::Ratio, band), true);
+        }
+        
+        processor.storeMorphSnapshot(PresetMorph::slotB);
+    }
+    
+    processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+    processor.prepareToPlay(config.sampleRate, config.blockSize);
+    
+    auto blockSize = config.hostBlockSize > 0 ? config.hostBlockSize : config.blockSize;
+    
+    //about one second of audio, but never fewer than 200 blocks
+    auto numBlocks = juce::jmax(200, static_cast<int>(config.sampleRate) / blockSize);
+    
+    juce::AudioBuffer<SampleType> source(numChannels, blockSize * 16);
+    Benchmarks::fillWithNoise(source, random);
+    
+    //silent runs start after the hold time, so they measure the steady state
+    auto warmupBlocks = 20;
+    if (config.silentInput)
+    {
+        source.clear();
+        warmupBlocks += static_cast<int>(config.sampleRate * 1.5) / blockSize;
+    }
+    
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    
+    std::vector<juce::int64> blockTicks;
+    blockTicks.reserve(static_cast<size_t>(numBlocks));
+    
+    std::array<juce::int64, StageTimings::numStages> stageTicks {};
+    juce::int64 allocations = 0;
+    
+    for (auto block = -warmupBlocks; block < numBlocks; ++block)
+    {
+        auto offset = (((block % 16) + 16) % 16) * blockSize;
+        for (auto ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, source, ch, offset, blockSize);
+        
+        if (config.automated)
+            automate(processor, block);
+        
+        if (config.morphing)
+            processor.apvts.getParameter(Params::getName(Params::Morph))->setValueNotifyingHost(0.5f + 0.5f * std::sin(0.05f * static_cast<float>(block)));
+        
+        auto allocationsBefore = Benchmarks::getAllocationCount();
+        auto start = juce::Time::getHighResolutionTicks();
+        
+        processor.processBlock(buffer, midi);
+        
+        auto ticks = juce::Time::getHighResolutionTicks() - start;
+        auto allocationsInBlock = Benchmarks::getAllocationCount() - allocationsBefore;
+        
+        //the first blocks only warm up caches and smoothers
+        if (block < 0)
+        {
+            processor.getProfiler().takeSnapshot();
+            continue;
+        }
+        
+        blockTicks.push_back(ticks);
+        allocations += allocationsInBlock;
+        
+        const auto& timings = processor.getStageTimings();
+        for (size_t stage = 0; stage < stageTicks.size(); ++stage)
+            stageTicks[stage] += timings.ticks[stage];
+    }
+    
+    auto totalSamples = static_cast<double>(numBlocks) * blockSize;
+    juce::int64 totalTicks = 0;
+    for (auto t : blockTicks)
+        totalTicks += t;
+    
+    std::sort(blockTicks.begin(), blockTicks.end());
+    
+    //the profiler's own view of the same blocks, as a fraction of the real-time budget
+    auto profile = processor.getProfiler().takeSnapshot();
+    
+    out << "process_block," << config.sampleRate << ',' << numMainChannels << ',' << numKeyChannels << ',' << config.blockSize << ',' << blockSize << ',' << getName(config.state) << ','
+        << (config.silentInput ? "silence" : "noise") << ',' << (config.elision ? "on" : "off") << ','
+        << (config.doublePrecision ? "double" : "float") << ',' << (config.automated ? "on" : "off") << ',' << getModeName(config, processor) << ',' << (config.morphing ? "on" : "off") << ','
+        << Benchmarks::ticksToNanoseconds(totalTicks) / totalSamples << ','
+        << percentile(blockTicks, 0.5) << ',' << percentile(blockTicks, 0.99) << ',' << percentile(blockTicks, 1.0) << ','
+        << static_cast<double>(allocations) / numBlocks << ',' << profile.maxLoad;
+    
+    for (auto t : stageTicks)
+        out << ',' << Benchmarks::ticksToNanoseconds(t) / totalSamples;
+    
+    out << '\n';
+}
+
+void runConfiguration(std::ostream& out, juce::Random& random, const Configuration& config)
+{
+    if (config.doublePrecision)
+        runConfiguration<double>(out, random, config);
+    else
+        runConfiguration<float>(out, random, config);
+}
+}
+
+void Benchmarks::runProcessBlockBenchmark(std::ostream& out)
+{
+    out << "suite,sample_rate,channels,sidechain_channels,block_size,host_block_size,band_state,input,elision,precision,automation,mode,morph,ns_per_sample,block_p50_us,block_p99_us,block_max_us,allocs_per_block,max_load";
+    
+    for (auto stage = 0; stage < StageTimings::numStages; ++stage)
+        out << ",stage_" << StageTimings::getStageName(stage) << "_ns_per_sample";
+    
+    out << '\n';
+    
+    juce::Random random(1234);
+    
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        for (const auto& channels : { juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create5point1(),
+                                      juce::AudioChannelSet::create7point1(), juce::AudioChannelSet::create7point1point4() })
+            for (auto blockSize = 16; blockSize <= 4096; blockSize *= 2)
+                for (auto state : { BandState::active, BandState::bypassed, BandState::soloed, BandState::muted })
+                    for (auto silentInput : { false, true })
+                        for (auto elision : { true, false })
+                            runConfiguration(out, random, { sampleRate, channels, blockSize, state, silentInput, elision });
+    
+    //the key shares the main crossover, so keying every band should cost well under double
+    for (const auto& sidechain : { juce::AudioChannelSet::disabled(), juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo() })
+        for (auto blockSize = 64; blockSize <= 1024; blockSize *= 4)
+            runConfiguration(out, random, { 48000.0, juce::AudioChannelSet::stereo(), blockSize, BandState::active, false, true, sidechain });
+    
+    //the double path against the float one it replaces when the host asks for double
+    for (auto sampleRate : { 48000.0, 192000.0 })
+        for (const auto& channels : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create7point1point4() })
+            for (auto doublePrecision : { false, true })
+                runConfiguration(out, random, { sampleRate, channels, 512, BandState::active, false, true, {}, doublePrecision });
+    
+    //hosts that send other sizes than they announced; processed in chunks of at most 512,
+    //the cost per sample should stay close to that of the matching 512 run
+    for (auto hostBlockSize : { 1, 3, 100, 512, 513, 3000, 8192 })
+        runConfiguration(out, random, { 48000.0, juce::AudioChannelSet::stereo(), 512, BandState::active, false, true, {}, false, hostBlockSize });
+    
+    //every smoothed parameter moving against none; the budget for automating everything is +20%
+    for (auto blockSize : { 64, 512 })
+        for (auto automated : { false, true })
+            runConfiguration(out, random, { 48000.0, juce::AudioChannelSet::stereo(), blockSize, BandState::active, false, true, {}, false, 0, automated });
+    
+    //an offline bounce splits and compresses on the worker pool at any block size, a live block
+    //only above minParallelBlockSize and minParallelSamples; with spare cores the offline rows
+    //should be the faster ones
+    for (const auto& channels : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create7point1point4() })
+        for (auto blockSize : { 256, 4096 })
+            for (auto offline : { false, true })
+                runConfiguration(out, random, { 48000.0, channels, blockSize, BandState::active, false, true, {}, false, 0, false, offline });
+    
+    //the same live blocks on the pool and off it, to show from which block size the pool pays
+    //off; by default a live block goes to the pool from minParallelBlockSize samples on
+    for (const auto& channels : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create5point1(), juce::AudioChannelSet::create7point1point4() })
+        for (auto blockSize = 64; blockSize <= 4096; blockSize *= 2)
+            for (auto parallelism : { SimpleMbCompAudioProcessor::LiveParallelism::never, SimpleMbCompAudioProcessor::LiveParallelism::always })
+            {
+                Configuration config { 48000.0, channels, blockSize, BandState::active, false, true };
+                config.parallelism = parallelism;
+                runConfiguration(out, random, config);
+            }
+    
+    //a running morph against a static setting; the blocks should cost about the same and p99 shouldn't jump
+    for (auto blockSize : { 64, 512 })
+        for (auto morphing : { false, true })
+            runConfiguration(out, random, { 48000.0, juce::AudioChannelSet::stereo(), blockSize, BandState::active, false, true, {}, false, 0, false, false, morphing });
+}
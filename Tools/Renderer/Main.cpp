@@ -0,0 +1,401 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Offline batch renderer: runs audio files through SimpleMbCompAudioProcessor
+    without a host.
+
+      SimpleMbCompRenderer [options] <input files...>
+
+        --output-dir <dir>     where rendered files go (default: next to the input, "_mbcomp" suffix)
+        --state <file>         state blob saved by getStateInformation
+        --param "<id>=<value>" parameter override in real units, e.g. "Threshold Low Band=-18"
+        --threads <n>          number of workers (default: number of CPU cores)
+        --block-size <n>       samples per processBlock call (default 512)
+        --format wav|aiff      output format (default: same as the input)
+        --bits <n>             output bit depth (default: same as the input)
+        --meters               also write per-band levels to "<output>_meters.csv"
+        --sidechain <file>     external key, read in step with every input; bands listen
+                               to it when their Sidechain parameter is on
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+struct RenderSettings
+{
+    juce::File outputDir;
+    juce::MemoryBlock state;
+    juce::StringPairArray parameterOverrides;
+    int blockSize = 512;
+    juce::String format;
+    int bitsPerSample = 0;
+    bool writeMeters = false;
+    juce::File sidechain;
+};
+
+juce::CriticalSection printLock;
+
+/** The bus layout a file is rendered with. canonicalChannelSet stops at 7.1, so twelve
+    channels are taken to be 7.1.4 in the usual order. */
+juce::AudioChannelSet getLayoutForChannelCount(int numChannels)
+{
+    if (numChannels == 12)
+        return juce::AudioChannelSet::create7point1point4();
+    
+    return juce::AudioChannelSet::canonicalChannelSet(numChannels);
+}
+
+void print(const juce::String& message)
+{
+    const juce::ScopedLock sl(printLock);
+    std::cout << message << std::endl;
+}
+
+bool fail(juce::String& error, const juce::String& message)
+{
+    error = message;
+    return false;
+}
+
+bool applyOverride(SimpleMbCompAudioProcessor& processor, const juce::String& id, const juce::String& text)
+{
+    auto* param = processor.apvts.getParameter(id);
+    
+    if (param == nullptr)
+        return false;
+    
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(param))
+    {
+        if (choice->choices.contains(text))
+        {
+            param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(choice->choices.indexOf(text))));
+            return true;
+        }
+        
+        //otherwise the choices are numbers (the ratios), so pick the nearest one
+        auto target = text.getFloatValue();
+        auto best = 0;
+        
+        for (auto i = 1; i < choice->choices.size(); ++i)
+        {
+            if (std::abs(choice->choices[i].getFloatValue() - target) < std::abs(choice->choices[best].getFloatValue() - target))
+                best = i;
+        }
+        
+        param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(best)));
+        return true;
+    }
+    
+    param->setValueNotifyingHost(param->getValueForText(text));
+    return true;
+}
+
+/*
+    A worker owns one processor and keeps pulling files until the queue is empty.
+    Files are streamed through in blockSize chunks, so memory use doesn't depend on
+    the file length.
+*/
+class RenderWorker  : public juce::ThreadPoolJob
+{
+public:
+    RenderWorker(std::unique_ptr<SimpleMbCompAudioProcessor> p,
+                 const juce::Array<juce::File>& files,
+                 std::atomic<int>& next,
+                 std::atomic<int>& failed,
+                 const RenderSettings& s)
+        : juce::ThreadPoolJob("RenderWorker"),
+          processor(std::move(p)), inputFiles(files), nextFile(next), numFailed(failed), settings(s)
+    {
+        formatManager.registerBasicFormats();
+    }
+    
+    JobStatus runJob() override
+    {
+        for (auto index = nextFile++; index < inputFiles.size() && ! shouldExit(); index = nextFile++)
+        {
+            juce::String error;
+            auto& input = inputFiles.getReference(index);
+            
+            if (render(input, error))
+            {
+                print("rendered " + input.getFullPathName());
+            }
+            else
+            {
+                print("failed   " + input.getFullPathName() + ": " + error);
+                ++numFailed;
+            }
+        }
+        
+        return jobHasFinished;
+    }
+    
+private:
+    std::unique_ptr<SimpleMbCompAudioProcessor> processor;
+    const juce::Array<juce::File>& inputFiles;
+    std::atomic<int>& nextFile;
+    std::atomic<int>& numFailed;
+    const RenderSettings& settings;
+    juce::AudioFormatManager formatManager;
+    
+    juce::AudioFormat* getOutputFormat(const juce::File& input)
+    {
+        if (settings.format.isNotEmpty())
+            return formatManager.findFormatForFileExtension(settings.format);
+        
+        return formatManager.findFormatForFileExtension(input.getFileExtension());
+    }
+    
+    bool render(const juce::File& input, juce::String& error)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+        
+        if (reader == nullptr)
+            return fail(error, "unsupported or unreadable file");
+        
+        auto numChannels = static_cast<int>(reader->numChannels);
+        auto sampleRate = reader->sampleRate;
+        auto blockSize = settings.blockSize;
+        
+        std::unique_ptr<juce::AudioFormatReader> keyReader;
+        
+        if (settings.sidechain != juce::File())
+        {
+            keyReader.reset(formatManager.createReaderFor(settings.sidechain));
+            
+            if (keyReader == nullptr)
+                return fail(error, "unsupported or unreadable sidechain file");
+        }
+        
+        auto numKeyChannels = keyReader != nullptr ? static_cast<int>(keyReader->numChannels) : 0;
+        
+        auto layout = processor->getBusesLayout();
+        layout.inputBuses.getReference(0) = getLayoutForChannelCount(numChannels);
+        layout.inputBuses.getReference(1) = numKeyChannels > 0 ? getLayoutForChannelCount(numKeyChannels) : juce::AudioChannelSet::disabled();
+        layout.outputBuses.getReference(0) = getLayoutForChannelCount(numChannels);
+        
+        if (! processor->setBusesLayout(layout))
+            return fail(error, "unsupported channel count " + juce::String(numChannels) + " with a "
+                               + juce::String(numKeyChannels) + " channel sidechain");
+        
+        auto* format = getOutputFormat(input);
+        
+        if (format == nullptr)
+            return fail(error, "no output format");
+        
+        auto outputDir = settings.outputDir == juce::File() ? input.getParentDirectory() : settings.outputDir;
+        auto suffix = settings.outputDir == juce::File() ? "_mbcomp" : "";
+        auto output = outputDir.getChildFile(input.getFileNameWithoutExtension() + suffix)
+                               .withFileExtension(format->getFileExtensions()[0]);
+        
+        if (output == input)
+            return fail(error, "output would overwrite the input");
+        
+        output.deleteFile();
+        
+        auto bits = settings.bitsPerSample > 0 ? settings.bitsPerSample : static_cast<int>(reader->bitsPerSample);
+        std::unique_ptr<juce::OutputStream> stream(new juce::FileOutputStream(output));
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+                                                                                sampleRate,
+                                                                                static_cast<unsigned int>(numChannels),
+                                                                                bits,
+                                                                                reader->metadataValues,
+                                                                                0));
+        
+        if (writer == nullptr)
+            return fail(error, "can't write " + output.getFullPathName());
+        
+        stream.release();
+        
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+        
+        //the output is trimmed by the reported latency and extended by the tail
+        auto latency = static_cast<juce::int64>(processor->getLatencySamples());
+        auto tail = static_cast<juce::int64>(std::ceil(processor->getTailLengthSeconds() * sampleRate));
+        auto totalIn = reader->lengthInSamples + latency + tail;
+        auto toSkip = latency;
+        
+        std::unique_ptr<juce::FileOutputStream> meterLog;
+        
+        if (settings.writeMeters)
+        {
+            auto logFile = output.getSiblingFile(output.getFileNameWithoutExtension() + "_meters.csv");
+            logFile.deleteFile();
+            meterLog = logFile.createOutputStream();
+            
+            if (meterLog == nullptr)
+                return fail(error, "can't write " + logFile.getFullPathName());
+            
+            writeMeterHeader(*meterLog);
+        }
+        
+        //the sidechain channels follow the main ones, as a host passes them
+        juce::AudioBuffer<float> buffer(numChannels + numKeyChannels, blockSize);
+        juce::MidiBuffer midi;
+        
+        for (juce::int64 pos = 0; pos < totalIn; pos += blockSize)
+        {
+            auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalIn - pos));
+            buffer.setSize(numChannels + numKeyChannels, numSamples, false, false, true);
+            
+            //reading past the end of the file fills with silence
+            juce::AudioBuffer<float> mainChannels(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            reader->read(&mainChannels, 0, numSamples, pos, true, true);
+            
+            if (keyReader != nullptr)
+            {
+                juce::AudioBuffer<float> keyChannels(buffer.getArrayOfWritePointers() + numChannels, numKeyChannels, numSamples);
+                keyReader->read(&keyChannels, 0, numSamples, pos, true, true);
+            }
+            
+            processor->processBlock(buffer, midi);
+            
+            //this thread is the only reader of the processor's meter queue
+            MeterFrame frame;
+            while (processor->getMeterFifo().pop(frame))
+            {
+                if (meterLog != nullptr)
+                    writeMeterFrame(*meterLog, frame, static_cast<double>(frame.endSample - latency) / sampleRate);
+            }
+            
+            auto skip = static_cast<int>(juce::jmin(toSkip, static_cast<juce::int64>(numSamples)));
+            toSkip -= skip;
+            
+            if (skip < numSamples && ! writer->writeFromAudioSampleBuffer(mainChannels, skip, numSamples - skip))
+                return fail(error, "write error");
+        }
+        
+        processor->releaseResources();
+        return true;
+    }
+    
+    static void writeMeterHeader(juce::OutputStream& out)
+    {
+        out << "time_s";
+        
+        for (size_t b = 0; b < Params::NumBands; ++b)
+        {
+            auto band = "band_" + Params::getBandName(b).toLowerCase();
+            out << "," << band << "_in_peak_db," << band << "_in_rms_db,"
+                << band << "_out_peak_db," << band << "_out_rms_db," << band << "_gr_db";
+        }
+        
+        out << "\n";
+    }
+    
+    static void writeMeterFrame(juce::OutputStream& out, const MeterFrame& frame, double time)
+    {
+        auto dB = [](float gain) { return juce::String(juce::Decibels::gainToDecibels(gain), 2); };
+        
+        //times before zero are still inside the latency the output file was trimmed by
+        out << juce::String(time, 4);
+        
+        for (const auto& band : frame.bands)
+        {
+            out << "," << dB(band.inputPeak) << "," << dB(band.inputRms) << "," << dB(band.outputPeak) << ","
+                << dB(band.outputRms) << "," << juce::String(band.gainReductionDb, 2);
+        }
+        
+        out << "\n";
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderWorker)
+};
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    RenderSettings settings;
+    juce::Array<juce::File> inputFiles;
+    auto numThreads = juce::SystemStats::getNumCpus();
+    
+    for (auto i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto next = [&] { return i + 1 < args.size() ? args[++i].text : juce::String(); };
+        
+        if (arg == "--output-dir")
+            settings.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+        else if (arg == "--state")
+            juce::File::getCurrentWorkingDirectory().getChildFile(next()).loadFileAsData(settings.state);
+        else if (arg == "--param")
+        {
+            auto pair = next();
+            settings.parameterOverrides.set(pair.upToFirstOccurrenceOf("=", false, false).trim(),
+                                            pair.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (arg == "--threads")
+            numThreads = juce::jmax(1, next().getIntValue());
+        else if (arg == "--block-size")
+            settings.blockSize = juce::jmax(1, next().getIntValue());
+        else if (arg == "--format")
+            settings.format = next();
+        else if (arg == "--bits")
+            settings.bitsPerSample = next().getIntValue();
+        else if (arg == "--meters")
+            settings.writeMeters = true;
+        else if (arg == "--sidechain")
+            settings.sidechain = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+        else if (arg.isOption())
+        {
+            std::cerr << "unknown option " << arg.text << std::endl;
+            return 1;
+        }
+        else
+            inputFiles.add(arg.resolveAsFile());
+    }
+    
+    if (inputFiles.isEmpty())
+    {
+        std::cerr << "usage: SimpleMbCompRenderer [--output-dir dir] [--state file] [--param \"id=value\"]"
+                     " [--threads n] [--block-size n] [--format wav|aiff] [--bits n] [--meters] [--sidechain file] files..." << std::endl;
+        return 1;
+    }
+    
+    if (settings.outputDir != juce::File())
+        settings.outputDir.createDirectory();
+    
+    numThreads = juce::jmin(numThreads, inputFiles.size());
+    
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> numFailed { 0 };
+    juce::ThreadPool pool(numThreads);
+    
+    //processors are set up here on the main thread, then each worker owns one
+    for (auto t = 0; t < numThreads; ++t)
+    {
+        auto processor = std::make_unique<SimpleMbCompAudioProcessor>();
+        
+        if (settings.state.getSize() > 0)
+            processor->setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+        
+        for (auto& id : settings.parameterOverrides.getAllKeys())
+        {
+            if (! applyOverride(*processor, id, settings.parameterOverrides[id]))
+            {
+                std::cerr << "unknown parameter " << id << std::endl;
+                return 1;
+            }
+        }
+        
+        pool.addJob(new RenderWorker(std::move(processor), inputFiles, nextFile, numFailed, settings), true);
+    }
+    
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(50);
+    
+    return numFailed.load() == 0 ? 0 : 1;
+}